@@ -0,0 +1,185 @@
+#include "../games/connect_four.h"
+#include "../games/connect_four_rollouts.h"
+#include "../games/tic_tac_toe.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+// Mid-game positions with several legal moves and no winner yet
+ConnectFour connectFourPosition() {
+    ConnectFour game(1);
+    for (int col : {3, 3, 2, 4, 4, 2, 5, 1}) {
+        game.makeMove(col);
+    }
+    return game;
+}
+
+TicTacToe ticTacToePosition() {
+    TicTacToe game(1);
+    for (int cell : {4, 0, 2}) {
+        game.makeMove(cell);
+    }
+    return game;
+}
+
+template <typename GameT>
+GameT position();
+
+template <>
+ConnectFour position<ConnectFour>() { return connectFourPosition(); }
+
+template <>
+TicTacToe position<TicTacToe>() { return ticTacToePosition(); }
+
+template <typename GameT>
+void BM_MakeMove(benchmark::State& state) {
+    const GameT base = position<GameT>();
+    const int action = base.getPossibleActions().front();
+    for (auto _ : state) {
+        GameT game = base;
+        game.makeMove(action);
+        benchmark::DoNotOptimize(game);
+    }
+}
+
+template <typename GameT>
+void BM_MakeUnmakeMove(benchmark::State& state) {
+    GameT game = position<GameT>();
+    const int action = game.getPossibleActions().front();
+    for (auto _ : state) {
+        game.makeMove(action);
+        game.unmakeMove(action);
+        benchmark::ClobberMemory();
+    }
+}
+
+template <typename GameT>
+void BM_GetPossibleActions(benchmark::State& state) {
+    const GameT game = position<GameT>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(game.getPossibleActions());
+    }
+}
+
+template <typename GameT>
+void BM_GenerateActions(benchmark::State& state) {
+    const GameT game = position<GameT>();
+    ActionList actions;
+    for (auto _ : state) {
+        game.generateActions(actions);
+        benchmark::DoNotOptimize(actions);
+    }
+}
+
+template <typename GameT>
+void BM_IsGameOver(benchmark::State& state) {
+    const GameT game = position<GameT>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(game.isGameOver());
+    }
+}
+
+template <typename GameT>
+void BM_Clone(benchmark::State& state) {
+    const GameT game = position<GameT>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(game.clone());
+    }
+}
+
+template <typename GameT>
+void BM_EvaluatePosition(benchmark::State& state) {
+    const GameT game = position<GameT>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(game.evaluatePosition());
+    }
+}
+
+template <typename GameT>
+void BM_IsWinningMove(benchmark::State& state) {
+    const GameT game = position<GameT>();
+    const auto actions = game.getPossibleActions();
+    for (auto _ : state) {
+        for (int action : actions) {
+            benchmark::DoNotOptimize(game.isWinningMove(action));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * actions.size());
+}
+
+// Threat detection, against the default of trying every move on a clone
+template <typename GameT>
+void BM_GenerateTacticalMoves(benchmark::State& state) {
+    const GameT game = position<GameT>();
+    const bool use_default = state.range(0) != 0;
+    ActionList wins;
+    ActionList blocks;
+    for (auto _ : state) {
+        if (use_default) {
+            game.Game::generateTacticalMoves(wins, blocks);
+        } else {
+            game.generateTacticalMoves(wins, blocks);
+        }
+        benchmark::DoNotOptimize(wins.size() + blocks.size());
+    }
+}
+
+template <typename GameT>
+void BM_GetHash(benchmark::State& state) {
+    const GameT game = position<GameT>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(game.getHash());
+    }
+}
+
+template <typename GameT>
+void BM_SerializeText(benchmark::State& state) {
+    const GameT game = position<GameT>();
+    GameT restored(1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(restored.deserialize(game.serialize()));
+    }
+}
+
+template <typename GameT>
+void BM_SerializeBinary(benchmark::State& state) {
+    const GameT game = position<GameT>();
+    GameT restored(1);
+    uint8_t buffer[Game::MAX_BINARY_SIZE];
+    for (auto _ : state) {
+        size_t size = game.serializeBinary(buffer, sizeof(buffer));
+        benchmark::DoNotOptimize(restored.deserializeBinary(buffer, size));
+    }
+}
+
+// Random playouts from the mid-game position; items are playouts
+void BM_ConnectFourBatchRollouts(benchmark::State& state) {
+    const ConnectFour game = connectFourPosition();
+    const int count = static_cast<int>(state.range(0));
+    Xoshiro256 rng(1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ConnectFourRollouts::play(game, count, rng));
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+} // namespace
+
+#define GAME_BENCHMARKS(GameT)                          \
+    BENCHMARK_TEMPLATE(BM_MakeMove, GameT);             \
+    BENCHMARK_TEMPLATE(BM_MakeUnmakeMove, GameT);       \
+    BENCHMARK_TEMPLATE(BM_GetPossibleActions, GameT);   \
+    BENCHMARK_TEMPLATE(BM_GenerateActions, GameT);      \
+    BENCHMARK_TEMPLATE(BM_IsGameOver, GameT);           \
+    BENCHMARK_TEMPLATE(BM_Clone, GameT);                \
+    BENCHMARK_TEMPLATE(BM_EvaluatePosition, GameT);     \
+    BENCHMARK_TEMPLATE(BM_IsWinningMove, GameT);        \
+    BENCHMARK_TEMPLATE(BM_GenerateTacticalMoves, GameT)->Arg(0)->Arg(1); \
+    BENCHMARK_TEMPLATE(BM_GetHash, GameT);              \
+    BENCHMARK_TEMPLATE(BM_SerializeText, GameT);        \
+    BENCHMARK_TEMPLATE(BM_SerializeBinary, GameT)
+
+GAME_BENCHMARKS(ConnectFour);
+GAME_BENCHMARKS(TicTacToe);
+
+BENCHMARK(BM_ConnectFourBatchRollouts)->Arg(1)->Arg(4)->Arg(16)->Arg(64);
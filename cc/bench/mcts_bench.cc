@@ -0,0 +1,77 @@
+#include "../mcts/mcts.h"
+#include "../games/connect_four.h"
+#include "../games/tic_tac_toe.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+constexpr int SIMULATIONS_PER_MOVE = 2000;
+
+// Search configurations compared by the benchmarks, selected by index
+enum Variant {
+    CLONE,           // Tree mode, one state copy per node
+    UNMAKE,          // Tree mode, make/unmake replay
+    TRANSPOSITIONS,  // UNMAKE with a transposition table
+    BATCHED,         // UNMAKE with 8 rollouts per simulation
+    ROOT,            // Root-parallel, make/unmake replay
+    LEAF,            // Leaf-parallel, make/unmake replay
+    SOLVER,          // UNMAKE with proven values
+    NUM_VARIANTS
+};
+
+const char* const VARIANT_NAMES[NUM_VARIANTS] = {
+    "clone", "unmake", "transpositions", "batched", "root", "leaf", "solver"
+};
+
+MCTSConfig makeConfig(int variant, int threads) {
+    MCTSConfig config;
+    config.num_simulations = SIMULATIONS_PER_MOVE;
+    config.num_threads = threads;
+    config.seed = 1;
+    config.use_unmake = variant != CLONE;
+    config.use_transpositions = variant == TRANSPOSITIONS;
+    config.rollouts_per_node = variant == BATCHED ? 8 : 1;
+    config.use_solver = variant == SOLVER;
+    if (variant == ROOT) config.search_mode = MCTSConfig::SearchMode::Root;
+    if (variant == LEAF) config.search_mode = MCTSConfig::SearchMode::Leaf;
+    return config;
+}
+
+// One full search per iteration from the opening position, which has no
+// immediate wins or blocks; items are rollouts, so items_per_second is the
+// playout rate
+template <typename EngineT, typename GameT>
+void BM_SelectAction(benchmark::State& state) {
+    int variant = static_cast<int>(state.range(0));
+    int threads = static_cast<int>(state.range(1));
+    MCTSConfig config = makeConfig(variant, threads);
+    EngineT search(config);
+    GameT game(1);
+
+    long long rollouts = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(search.selectAction(&game));
+        rollouts += static_cast<long long>(search.getSimulationCount()) * config.rollouts_per_node;
+    }
+    state.SetItemsProcessed(rollouts);
+    state.SetLabel(VARIANT_NAMES[variant]);
+}
+
+void searchArguments(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgNames({"variant", "threads"});
+    for (int variant = 0; variant < NUM_VARIANTS; ++variant) {
+        for (int threads : {1, 2, 4, 8}) {
+            // The parallel modes only differ from tree mode with several threads
+            if ((variant == ROOT || variant == LEAF) && threads == 1) continue;
+            benchmark->Args({variant, threads});
+        }
+    }
+    benchmark->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+} // namespace
+
+// Searches specialized for the game, and the virtual-dispatch MCTS over Game
+BENCHMARK_TEMPLATE(BM_SelectAction, BasicMCTS<ConnectFour>, ConnectFour)->Apply(searchArguments);
+BENCHMARK_TEMPLATE(BM_SelectAction, MCTS, ConnectFour)->Apply(searchArguments);
+BENCHMARK_TEMPLATE(BM_SelectAction, BasicMCTS<TicTacToe>, TicTacToe)->Apply(searchArguments);
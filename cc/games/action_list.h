@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+
+/**
+ * Fixed-capacity list of actions stored inline.
+ * Used by the move generation hot paths so that producing the legal moves
+ * of a position never touches the heap.
+ */
+class ActionList {
+public:
+    static constexpr int CAPACITY = 64;
+
+    void push_back(int action) {
+        assert(count < CAPACITY);
+        actions[count++] = action;
+    }
+    void pop_back() { --count; }
+    void clear() { count = 0; }
+
+    // Removes the action at index i by moving the last action into its slot
+    void swapRemove(int i) { actions[i] = actions[--count]; }
+
+    bool contains(int action) const {
+        for (int i = 0; i < count; ++i) {
+            if (actions[i] == action) return true;
+        }
+        return false;
+    }
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    int back() const { return actions[count - 1]; }
+
+    int& operator[](int i) { return actions[i]; }
+    int operator[](int i) const { return actions[i]; }
+
+    int* begin() { return actions.data(); }
+    int* end() { return actions.data() + count; }
+    const int* begin() const { return actions.data(); }
+    const int* end() const { return actions.data() + count; }
+
+private:
+    std::array<int, CAPACITY> actions;
+    int count = 0;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+// Small bit-twiddling helpers shared by the bitboard game implementations.
+namespace bits {
+
+inline int popcount(uint64_t x) {
+    return __builtin_popcountll(x);
+}
+
+// Index of the lowest set bit; x must be non-zero.
+inline int lowestBit(uint64_t x) {
+    return __builtin_ctzll(x);
+}
+
+// Index of the highest set bit; x must be non-zero.
+inline int highestBit(uint64_t x) {
+    return 63 - __builtin_clzll(x);
+}
+
+// Low num_bytes bytes of x, least significant first, as in binary states.
+inline void storeBytes(uint8_t* out, uint64_t x, int num_bytes) {
+    for (int i = 0; i < num_bytes; ++i) {
+        out[i] = static_cast<uint8_t>(x >> (8 * i));
+    }
+}
+
+inline uint64_t loadBytes(const uint8_t* in, int num_bytes) {
+    uint64_t x = 0;
+    for (int i = 0; i < num_bytes; ++i) {
+        x |= uint64_t(in[i]) << (8 * i);
+    }
+    return x;
+}
+
+} // namespace bits
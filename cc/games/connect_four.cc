@@ -1,104 +1,95 @@
 #include "connect_four.h"
+#include <array>
 #include <iostream>
 #include <sstream>
-#include <algorithm>
-#include <cmath>
+#include <stdexcept>
 
-ConnectFour::ConnectFour(int starting_player) 
-    : board(ROWS, std::vector<int>(COLS, 0)), current_player(starting_player) {}
+namespace {
 
-bool ConnectFour::isGameOver() const {
-    // Check each cell for a win
-    for (int row = 0; row < ROWS; ++row) {
-        for (int col = 0; col < COLS; ++col) {
-            if (board[row][col] != 0) {
-                // Check all directions
-                if (checkDirection(row, col, 0, 1) ||  // Horizontal
-                    checkDirection(row, col, 1, 0) ||  // Vertical
-                    checkDirection(row, col, 1, 1) ||  // Diagonal (positive slope)
-                    checkDirection(row, col, 1, -1)) { // Diagonal (negative slope)
-                    return true;
+constexpr int NUM_WINDOWS = 69;
+
+// Every four-cell window on the board (horizontal, vertical and both diagonals)
+constexpr std::array<uint64_t, NUM_WINDOWS> makeWindows() {
+    std::array<uint64_t, NUM_WINDOWS> windows{};
+    const int directions[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};  // (dcol, drow)
+    int count = 0;
+    for (const auto& dir : directions) {
+        for (int col = 0; col < ConnectFour::COLS; ++col) {
+            for (int row = 0; row < ConnectFour::ROWS; ++row) {
+                int end_col = col + 3 * dir[0];
+                int end_row = row + 3 * dir[1];
+                if (end_col < 0 || end_col >= ConnectFour::COLS ||
+                    end_row < 0 || end_row >= ConnectFour::ROWS) continue;
+
+                uint64_t window = 0;
+                for (int i = 0; i < 4; ++i) {
+                    window |= uint64_t(1) << ((col + i * dir[0]) * ConnectFour::HEIGHT + row + i * dir[1]);
                 }
+                windows[count++] = window;
             }
         }
     }
-    
-    // Check if board is full
-    for (int col = 0; col < COLS; ++col) {
-        if (board[0][col] == 0) return false;
-    }
-    return true;
+    return windows;
 }
 
-std::vector<int> ConnectFour::getPossibleActions() const {
-    std::vector<int> actions;
-    for (int col = 0; col < COLS; ++col) {
-        if (board[0][col] == 0) {
-            actions.push_back(col);
+constexpr std::array<uint64_t, NUM_WINDOWS> WINDOWS = makeWindows();
+
+// A cell lies in at most 4 windows per direction
+constexpr int MAX_CELL_WINDOWS = 16;
+
+struct CellWindows {
+    int count;
+    uint64_t windows[MAX_CELL_WINDOWS];
+};
+
+// Windows through each cell, by bit index
+constexpr std::array<CellWindows, ConnectFour::COLS * ConnectFour::HEIGHT> makeCellWindows() {
+    std::array<CellWindows, ConnectFour::COLS * ConnectFour::HEIGHT> cells{};
+    for (uint64_t window : WINDOWS) {
+        for (int bit = 0; bit < ConnectFour::COLS * ConnectFour::HEIGHT; ++bit) {
+            if (window & (uint64_t(1) << bit)) {
+                CellWindows& cell = cells[bit];
+                cell.windows[cell.count++] = window;
+            }
         }
     }
-    return actions;
+    return cells;
 }
 
-void ConnectFour::makeMove(int action) {
-    if (action < 0 || action >= COLS) return;
-    
-    int row = getRowForColumn(action);
-    if (row >= 0) {
-        board[row][action] = current_player;
-        current_player = (current_player == 1) ? 2 : 1;
-    }
+constexpr std::array<CellWindows, ConnectFour::COLS * ConnectFour::HEIGHT> CELL_WINDOWS = makeCellWindows();
+
+// Value of a window holding stones of one player only, by stone count
+constexpr int WINDOW_WEIGHTS[5] = {0, 10, 100, 1000, 10000};
+
+// Score of a window for player 1; windows holding stones of both are worthless
+inline int windowScore(int player1_count, int player2_count) {
+    if (player1_count > 0 && player2_count > 0) return 0;
+    return WINDOW_WEIGHTS[player1_count] - WINDOW_WEIGHTS[player2_count];
 }
 
-int ConnectFour::getReward(int player) const {
-    // Check for win
-    for (int row = 0; row < ROWS; ++row) {
-        for (int col = 0; col < COLS; ++col) {
-            if (board[row][col] == player) {
-                // Check all directions
-                if (checkDirection(row, col, 0, 1) ||  // Horizontal
-                    checkDirection(row, col, 1, 0) ||  // Vertical
-                    checkDirection(row, col, 1, 1) ||  // Diagonal (positive slope)
-                    checkDirection(row, col, 1, -1)) { // Diagonal (negative slope)
-                    return 1;
-                }
-            }
-        }
-    }
-    
-    // Check for opponent win
-    int opponent = (player == 1) ? 2 : 1;
-    for (int row = 0; row < ROWS; ++row) {
-        for (int col = 0; col < COLS; ++col) {
-            if (board[row][col] == opponent) {
-                // Check all directions
-                if (checkDirection(row, col, 0, 1) ||  // Horizontal
-                    checkDirection(row, col, 1, 0) ||  // Vertical
-                    checkDirection(row, col, 1, 1) ||  // Diagonal (positive slope)
-                    checkDirection(row, col, 1, -1)) { // Diagonal (negative slope)
-                    return -1;
-                }
-            }
-        }
+} // namespace
+
+ConnectFour::ConnectFour(int starting_player)
+    : boards{0, 0}, current_player(starting_player), winner(0), num_moves(0), score(0) {
+    if (starting_player != 1 && starting_player != 2) {
+        throw std::invalid_argument("Starting player must be 1 or 2");
     }
-    
-    // Check for draw
-    bool is_full = true;
-    for (int col = 0; col < COLS; ++col) {
-        if (board[0][col] == 0) {
-            is_full = false;
-            break;
-        }
+}
+
+std::vector<int> ConnectFour::getPossibleActions() const {
+    uint64_t playable = ~getOccupiedMask() & TOP_ROW_MASK;
+
+    std::vector<int> actions;
+    actions.reserve(bits::popcount(playable));
+    while (playable) {
+        actions.push_back(bits::lowestBit(playable) / HEIGHT);
+        playable &= playable - 1;
     }
-    if (is_full) return 0;
-    
-    return -1; // Game not over
+    return actions;
 }
 
 std::unique_ptr<Game> ConnectFour::clone() const {
-    auto clone = std::make_unique<ConnectFour>(current_player);
-    clone->board = board;
-    return clone;
+    return std::make_unique<ConnectFour>(*this);
 }
 
 void ConnectFour::printState() const {
@@ -107,12 +98,13 @@ void ConnectFour::printState() const {
         std::cout << col << " ";
     }
     std::cout << "\n";
-    
+
     for (int row = 0; row < ROWS; ++row) {
         std::cout << row << " ";
         for (int col = 0; col < COLS; ++col) {
-            char symbol = board[row][col] == 0 ? '.' : 
-                         board[row][col] == 1 ? 'X' : 'O';
+            int cell = cellAt(row, col);
+            char symbol = cell == 0 ? '.' :
+                         cell == 1 ? 'X' : 'O';
             std::cout << symbol << " ";
         }
         std::cout << "\n";
@@ -125,7 +117,7 @@ std::string ConnectFour::serialize() const {
     ss << current_player << " ";
     for (int row = 0; row < ROWS; ++row) {
         for (int col = 0; col < COLS; ++col) {
-            ss << board[row][col] << " ";
+            ss << cellAt(row, col) << " ";
         }
     }
     return ss.str();
@@ -133,148 +125,114 @@ std::string ConnectFour::serialize() const {
 
 bool ConnectFour::deserialize(const std::string& state) {
     std::stringstream ss(state);
-    ss >> current_player;
+    int player;
+    if (!(ss >> player) || (player != 1 && player != 2)) return false;
+
+    uint64_t new_boards[2] = {0, 0};
     for (int row = 0; row < ROWS; ++row) {
         for (int col = 0; col < COLS; ++col) {
-            if (!(ss >> board[row][col])) return false;
+            int cell;
+            if (!(ss >> cell) || cell < 0 || cell > 2) return false;
+            if (cell != 0) new_boards[cell - 1] |= cellMask(row, col);
         }
     }
-    return true;
+
+    return setState(new_boards[0], new_boards[1], player);
 }
 
-double ConnectFour::evaluatePosition() const {
-    double score = 0.0;
-    
-    // Evaluate horizontal lines
-    for (int row = 0; row < ROWS; ++row) {
-        for (int col = 0; col <= COLS - 4; ++col) {
-            std::vector<int> line;
-            for (int i = 0; i < 4; ++i) {
-                line.push_back(board[row][col + i]);
-            }
-            score += evaluateLine(line);
-        }
-    }
-    
-    // Evaluate vertical lines
-    for (int col = 0; col < COLS; ++col) {
-        for (int row = 0; row <= ROWS - 4; ++row) {
-            std::vector<int> line;
-            for (int i = 0; i < 4; ++i) {
-                line.push_back(board[row + i][col]);
-            }
-            score += evaluateLine(line);
-        }
-    }
-    
-    // Evaluate diagonal lines (positive slope)
-    for (int row = 3; row < ROWS; ++row) {
-        for (int col = 0; col <= COLS - 4; ++col) {
-            std::vector<int> line;
-            for (int i = 0; i < 4; ++i) {
-                line.push_back(board[row - i][col + i]);
-            }
-            score += evaluateLine(line);
-        }
-    }
-    
-    // Evaluate diagonal lines (negative slope)
-    for (int row = 0; row <= ROWS - 4; ++row) {
-        for (int col = 0; col <= COLS - 4; ++col) {
-            std::vector<int> line;
-            for (int i = 0; i < 4; ++i) {
-                line.push_back(board[row + i][col + i]);
-            }
-            score += evaluateLine(line);
-        }
-    }
+namespace {
+
+constexpr size_t BINARY_BOARD_BYTES = 7;  // 49 bits
+constexpr size_t BINARY_SIZE = 2 + BINARY_BOARD_BYTES;
+
+} // namespace
+
+size_t ConnectFour::serializeBinary(uint8_t* buffer, size_t capacity) const {
+    if (capacity < BINARY_SIZE) return 0;
     
-    return score;
+    buffer[0] = BINARY_FORMAT_VERSION;
+    buffer[1] = static_cast<uint8_t>(current_player);
+    bits::storeBytes(buffer + 2, boards[0] + getOccupiedMask() + BOTTOM_ROW_MASK, BINARY_BOARD_BYTES);
+    return BINARY_SIZE;
 }
 
-bool ConnectFour::isWinningMove(int action) const {
-    if (action < 0 || action >= COLS) return false;
-    
-    int row = getRowForColumn(action);
-    if (row < 0) return false;
-    
-    // Create a temporary copy of the board
-    std::vector<std::vector<int>> temp_board = board;
-    temp_board[row][action] = current_player;
+bool ConnectFour::deserializeBinary(const uint8_t* data, size_t size) {
+    if (size != BINARY_SIZE || data[0] != BINARY_FORMAT_VERSION || (data[1] != 1 && data[1] != 2)) {
+        return false;
+    }
     
-    // Check if this move wins
-    int player = temp_board[row][action];
-    if (player == 0) return false;
+    // The highest bit of each column is its marker; the stones below it
+    // belong to player 1 where set and to player 2 where clear
+    uint64_t packed = bits::loadBytes(data + 2, BINARY_BOARD_BYTES);
+    if (packed & ~(BOARD_MASK | (BOTTOM_ROW_MASK << ROWS))) return false;
     
-    // Check all directions
-    return checkDirection(row, action, 0, 1, temp_board) ||  // Horizontal
-           checkDirection(row, action, 1, 0, temp_board) ||  // Vertical
-           checkDirection(row, action, 1, 1, temp_board) ||  // Diagonal (positive slope)
-           checkDirection(row, action, 1, -1, temp_board);   // Diagonal (negative slope)
+    uint64_t new_boards[2] = {0, 0};
+    for (int col = 0; col < COLS; ++col) {
+        uint64_t column = (packed >> (col * HEIGHT)) & ((uint64_t(1) << HEIGHT) - 1);
+        if (column == 0) return false;
+        uint64_t marker = uint64_t(1) << bits::highestBit(column);
+        uint64_t stones = (marker - 1) << (col * HEIGHT);
+        uint64_t first = (column ^ marker) << (col * HEIGHT);
+        new_boards[0] |= first;
+        new_boards[1] |= stones ^ first;
+    }
+    return setState(new_boards[0], new_boards[1], data[1]);
 }
 
-bool ConnectFour::checkDirection(int row, int col, int drow, int dcol, const std::vector<std::vector<int>>& board) const {
-    int player = board[row][col];
-    int count = 1;
-    
-    // Check in positive direction
-    for (int i = 1; i < 4; ++i) {
-        int new_row = row + i * drow;
-        int new_col = col + i * dcol;
-        if (new_row < 0 || new_row >= ROWS || new_col < 0 || new_col >= COLS) break;
-        if (board[new_row][new_col] != player) break;
-        count++;
-    }
-    
-    // Check in negative direction
-    for (int i = 1; i < 4; ++i) {
-        int new_row = row - i * drow;
-        int new_col = col - i * dcol;
-        if (new_row < 0 || new_row >= ROWS || new_col < 0 || new_col >= COLS) break;
-        if (board[new_row][new_col] != player) break;
-        count++;
+bool ConnectFour::setState(uint64_t first, uint64_t second, int player) {
+    // Every stone must rest on the bottom or on another stone
+    uint64_t occupied = first | second;
+    for (int col = 0; col < COLS; ++col) {
+        uint64_t column = (occupied >> (col * HEIGHT)) & ((uint64_t(1) << ROWS) - 1);
+        if (column & (column + 1)) return false;
     }
-    
-    return count >= 4;
+
+    boards[0] = first;
+    boards[1] = second;
+    current_player = player;
+    winner = hasFour(boards[0]) ? 1 : hasFour(boards[1]) ? 2 : 0;
+    num_moves = bits::popcount(occupied);
+    score = computeScore();
+    return true;
 }
 
-bool ConnectFour::checkDirection(int row, int col, int drow, int dcol) const {
-    return checkDirection(row, col, drow, dcol, board);
+double ConnectFour::evaluatePosition() const {
+    return score;
 }
 
-int ConnectFour::getRowForColumn(int col) const {
-    for (int row = ROWS - 1; row >= 0; --row) {
-        if (board[row][col] == 0) {
-            return row;
+int ConnectFour::scoreDelta(uint64_t stone, int player) const {
+    const uint64_t own = boards[player - 1];
+    const uint64_t other = boards[2 - player];
+    const CellWindows& cell = CELL_WINDOWS[bits::lowestBit(stone)];
+
+    // From the player's point of view: the stone raises a window of its own
+    // by one weight step, blocks a window of the other player and leaves
+    // mixed windows at 0
+    int delta = 0;
+    for (int i = 0; i < cell.count; ++i) {
+        uint64_t mine = own & cell.windows[i];
+        uint64_t theirs = other & cell.windows[i];
+        if (!theirs) {
+            int count = bits::popcount(mine);
+            delta += WINDOW_WEIGHTS[count + 1] - WINDOW_WEIGHTS[count];
+        } else if (!mine) {
+            delta += WINDOW_WEIGHTS[bits::popcount(theirs)];
         }
     }
-    return -1;
+    return player == 1 ? delta : -delta;
 }
 
-double ConnectFour::evaluateLine(const std::vector<int>& line) const {
-    int player1_count = 0;
-    int player2_count = 0;
-    int empty_count = 0;
-    
-    for (int cell : line) {
-        if (cell == 0) empty_count++;
-        else if (cell == 1) player1_count++;
-        else player2_count++;
-    }
-    
-    // If line is blocked by opponent, it's worthless
-    if (player1_count > 0 && player2_count > 0) return 0.0;
-    
-    // If line is empty, it's worthless
-    if (empty_count == 4) return 0.0;
-    
-    // Score based on number of pieces in line
-    double score = 0.0;
-    if (player1_count > 0) {
-        score = std::pow(10.0, player1_count);
-    } else if (player2_count > 0) {
-        score = -std::pow(10.0, player2_count);
+int ConnectFour::computeScore() const {
+    int total = 0;
+    for (uint64_t window : WINDOWS) {
+        total += windowScore(bits::popcount(boards[0] & window), bits::popcount(boards[1] & window));
     }
-    
-    return score;
-} 
\ No newline at end of file
+    return total;
+}
+
+int ConnectFour::cellAt(int row, int col) const {
+    uint64_t cell = cellMask(row, col);
+    if (boards[0] & cell) return 1;
+    if (boards[1] & cell) return 2;
+    return 0;
+}
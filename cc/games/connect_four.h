@@ -1,43 +1,242 @@
 #pragma once
 
 #include "game.h"
+#include "bit_utils.h"
+#include <cstdint>
 #include <vector>
 #include <string>
 
-class ConnectFour : public Game {
+/**
+ * ConnectFour game implementation backed by two 64-bit bitboards.
+ *
+ * Each column occupies HEIGHT = ROWS + 1 consecutive bits, bottom row first,
+ * with the extra bit kept empty as a sentinel so that shifts never carry a
+ * line from one column into the next:
+ *
+ *   6 13 20 27 34 41 48
+ *   5 12 19 26 33 40 47   <- top row
+ *   ...
+ *   0  7 14 21 28 35 42   <- bottom row
+ *
+ * Rows in the public interface (printState, serialize) are still numbered
+ * 0-5 from top to bottom.
+ *
+ * The winner, the number of stones and the heuristic score are kept up to
+ * date by makeMove and unmakeMove, so terminal checks and evaluation do not
+ * look at the board.
+ */
+class ConnectFour final : public Game {
 public:
     static constexpr int ROWS = 6;
     static constexpr int COLS = 7;
-    
+    static constexpr int HEIGHT = ROWS + 1;
+
+    // Bottom cell of every column (bits 0, 7, ..., 42), the playable cells
+    // and the top cell of every column
+    static constexpr uint64_t BOTTOM_ROW_MASK = 0x0040810204081ULL;
+    static constexpr uint64_t BOARD_MASK = BOTTOM_ROW_MASK * ((uint64_t(1) << ROWS) - 1);
+    static constexpr uint64_t TOP_ROW_MASK = BOTTOM_ROW_MASK << (ROWS - 1);
+
+    // Cells of one column: its bottom cell, its top cell and all of them
+    static constexpr uint64_t bottomMask(int col) { return uint64_t(1) << (col * HEIGHT); }
+    static constexpr uint64_t topMask(int col) { return uint64_t(1) << (col * HEIGHT + ROWS - 1); }
+    static constexpr uint64_t columnMask(int col) { return ((uint64_t(1) << ROWS) - 1) << (col * HEIGHT); }
+    // Lowest empty cell of every column that is not full
+    static constexpr uint64_t playableCells(uint64_t mask) { return (mask + BOTTOM_ROW_MASK) & BOARD_MASK; }
+
     ConnectFour(int starting_player = 1);
-    
+
     // Core game mechanics
     bool isGameOver() const override;
     std::vector<int> getPossibleActions() const override;
     void makeMove(int action) override;
+    void unmakeMove(int action) override;
     int getReward(int player) const override;
     std::unique_ptr<Game> clone() const override;
     void printState() const override;
-    
+    void generateActions(ActionList& actions) const override;
+
     // Game state management
     std::string serialize() const override;
     bool deserialize(const std::string& state) override;
-    
+    // Board packed as player 1's stones plus one marker bit above each
+    // column's top stone: one 7-bit group per column
+    size_t serializeBinary(uint8_t* buffer, size_t capacity) const override;
+    bool deserializeBinary(const uint8_t* data, size_t size) override;
+    uint64_t getHash() const override;
+
     // Heuristic evaluation
     double evaluatePosition() const override;
     bool isWinningMove(int action) const override;
-    
+    void generateTacticalMoves(ActionList& wins, ActionList& blocks) const override;
+
     // Game-specific information
     int getCurrentPlayer() const override { return current_player; }
     int getBoardSize() const override { return ROWS * COLS; }
     std::string getGameName() const override { return "Connect Four"; }
-    
+
+    // Bitboard access
+    uint64_t getPlayerBoard(int player) const { return boards[player - 1]; }
+    uint64_t getOccupiedMask() const { return boards[0] | boards[1]; }
+
+    // Player with four in a row, or 0
+    int getWinner() const { return winner; }
+    int getMoveCount() const { return num_moves; }
+
+    static bool hasFour(uint64_t board);
+    // Empty cells, playable or not, that would complete a line of position
+    static uint64_t winningCells(uint64_t position, uint64_t mask);
+
 private:
-    std::vector<std::vector<int>> board;
+    uint64_t boards[2];  // stones of player 1 and player 2
     int current_player;
-    
-    bool checkDirection(int row, int col, int drow, int dcol) const;
-    bool checkDirection(int row, int col, int drow, int dcol, const std::vector<std::vector<int>>& board) const;
-    int getRowForColumn(int col) const;
-    double evaluateLine(const std::vector<int>& line) const;
-}; 
\ No newline at end of file
+    int winner;          // 0 while nobody has four in a row
+    int num_moves;       // stones on the board
+    int score;           // evaluatePosition(), from player 1's point of view
+
+    static constexpr uint64_t cellMask(int row, int col) { return uint64_t(1) << (col * HEIGHT + ROWS - 1 - row); }
+    static void appendColumns(ActionList& actions, uint64_t cells);
+
+    bool canPlay(int col) const;
+    uint64_t moveMask(int col) const;
+    int cellAt(int row, int col) const;
+    // Change of score when player places stone, from the windows through it
+    int scoreDelta(uint64_t stone, int player) const;
+    int computeScore() const;
+    // Replaces the state; false if a stone floats above an empty cell
+    bool setState(uint64_t first, uint64_t second, int player);
+};
+
+// Hot paths, inline for BasicMCTS<ConnectFour>
+
+inline bool ConnectFour::hasFour(uint64_t board) {
+    // Vertical, horizontal and the two diagonals; the sentinel row keeps
+    // shifted lines from wrapping between columns
+    static constexpr int shifts[4] = {1, HEIGHT, HEIGHT - 1, HEIGHT + 1};
+    for (int shift : shifts) {
+        uint64_t pairs = board & (board >> shift);
+        if (pairs & (pairs >> (2 * shift))) return true;
+    }
+    return false;
+}
+
+inline uint64_t ConnectFour::winningCells(uint64_t position, uint64_t mask) {
+    // Vertical: three stones right below the cell
+    uint64_t cells = (position << 1) & (position << 2) & (position << 3);
+
+    // Horizontal and both diagonals: the cell is one end of the line or
+    // one of its two inner cells
+    static constexpr int shifts[3] = {HEIGHT, HEIGHT - 1, HEIGHT + 1};
+    for (int shift : shifts) {
+        uint64_t pair = (position << shift) & (position << 2 * shift);
+        cells |= pair & (position << 3 * shift);
+        cells |= pair & (position >> shift);
+        pair = (position >> shift) & (position >> 2 * shift);
+        cells |= pair & (position << shift);
+        cells |= pair & (position >> 3 * shift);
+    }
+    return cells & (BOARD_MASK ^ mask);
+}
+
+inline uint64_t ConnectFour::getHash() const {
+    // Each column's stones are contiguous from the bottom, so adding player
+    // 1's stones to the occupied cells is unique and fits in the column's
+    // 7 bits. The top bit encodes the side to move.
+    uint64_t key = boards[0] + getOccupiedMask();
+    return current_player == 2 ? key | (uint64_t(1) << 63) : key;
+}
+
+inline bool ConnectFour::isGameOver() const {
+    return winner != 0 || num_moves == ROWS * COLS;
+}
+
+inline void ConnectFour::generateActions(ActionList& actions) const {
+    uint64_t playable = ~getOccupiedMask() & TOP_ROW_MASK;
+
+    actions.clear();
+    while (playable) {
+        actions.push_back(bits::lowestBit(playable) / HEIGHT);
+        playable &= playable - 1;
+    }
+}
+
+inline void ConnectFour::makeMove(int action) {
+    if (action < 0 || action >= COLS || !canPlay(action)) return;
+
+    // A line found now must run through the new stone, as there was
+    // none before it
+    uint64_t move = moveMask(action);
+    score += scoreDelta(move, current_player);
+    uint64_t& board = boards[current_player - 1];
+    board |= move;
+    if (winner == 0 && hasFour(board)) winner = current_player;
+    ++num_moves;
+    current_player = (current_player == 1) ? 2 : 1;
+}
+
+inline void ConnectFour::unmakeMove(int action) {
+    if (action < 0 || action >= COLS) return;
+
+    uint64_t stones = getOccupiedMask() & columnMask(action);
+    if (!stones) return;
+
+    // The top stone of the column belongs to the player who moved last
+    int previous_player = (current_player == 1) ? 2 : 1;
+    uint64_t stone = uint64_t(1) << bits::highestBit(stones);
+    uint64_t& board = boards[previous_player - 1];
+    board &= ~stone;
+    score -= scoreDelta(stone, previous_player);
+    if (winner == previous_player && !hasFour(board)) winner = 0;
+    --num_moves;
+    current_player = previous_player;
+}
+
+inline int ConnectFour::getReward(int player) const {
+    if (winner != 0) return winner == player ? 1 : -1;
+    if (num_moves == ROWS * COLS) return 0;
+
+    return -1; // Game not over
+}
+
+inline bool ConnectFour::isWinningMove(int action) const {
+    if (action < 0 || action >= COLS || !canPlay(action)) return false;
+    return hasFour(boards[current_player - 1] | moveMask(action));
+}
+
+inline void ConnectFour::generateTacticalMoves(ActionList& wins, ActionList& blocks) const {
+    uint64_t mask = getOccupiedMask();
+    uint64_t playable = playableCells(mask);
+    uint64_t threats = winningCells(boards[2 - current_player], mask);
+
+    wins.clear();
+    blocks.clear();
+    appendColumns(wins, winningCells(boards[current_player - 1], mask) & playable);
+
+    // A single playable threat is blocked by taking its cell, unless that
+    // lets the opponent win right on top of it; two cannot both be blocked.
+    // Without one, the unsafe moves are those right below a threat.
+    uint64_t forced = threats & playable;
+    if (forced) {
+        if (!(forced & (forced - 1)) && !(threats & (forced << 1))) {
+            appendColumns(blocks, forced);
+        }
+    } else if (playable & (threats >> 1)) {
+        appendColumns(blocks, playable & ~(threats >> 1));
+    }
+}
+
+inline void ConnectFour::appendColumns(ActionList& actions, uint64_t cells) {
+    while (cells) {
+        actions.push_back(bits::lowestBit(cells) / HEIGHT);
+        cells &= cells - 1;
+    }
+}
+
+inline bool ConnectFour::canPlay(int col) const {
+    return (getOccupiedMask() & topMask(col)) == 0;
+}
+
+inline uint64_t ConnectFour::moveMask(int col) const {
+    // Adding the column's bottom bit carries into the lowest empty cell
+    return (getOccupiedMask() + bottomMask(col)) & columnMask(col);
+}
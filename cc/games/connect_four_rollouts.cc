@@ -0,0 +1,115 @@
+#include "connect_four_rollouts.h"
+#include <algorithm>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Lowest set bit of bits once the first k set bits are dropped
+inline uint64_t nthSetBit(uint64_t bits, int k) {
+    while (k-- > 0) bits &= bits - 1;
+    return bits & (~bits + 1);
+}
+
+#if defined(__AVX2__)
+template <int SHIFT>
+inline __m256i lines256(__m256i board) {
+    __m256i pairs = _mm256_and_si256(board, _mm256_srli_epi64(board, SHIFT));
+    return _mm256_and_si256(pairs, _mm256_srli_epi64(pairs, 2 * SHIFT));
+}
+#endif
+
+#if defined(__SSE2__)
+template <int SHIFT>
+inline __m128i lines128(__m128i board) {
+    __m128i pairs = _mm_and_si128(board, _mm_srli_epi64(board, SHIFT));
+    return _mm_and_si128(pairs, _mm_srli_epi64(pairs, 2 * SHIFT));
+}
+#endif
+
+} // namespace
+
+void ConnectFourRollouts::findWins(const uint64_t* boards, uint64_t* wins, int lanes) {
+    // Same shifts as ConnectFour::hasFour: vertical, horizontal, both diagonals
+    int lane = 0;
+#if defined(__AVX2__)
+    for (; lane + 4 <= lanes; lane += 4) {
+        __m256i board = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(boards + lane));
+        __m256i found = _mm256_or_si256(
+            _mm256_or_si256(lines256<1>(board), lines256<ConnectFour::HEIGHT>(board)),
+            _mm256_or_si256(lines256<ConnectFour::HEIGHT - 1>(board), lines256<ConnectFour::HEIGHT + 1>(board)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(wins + lane), found);
+    }
+#endif
+#if defined(__SSE2__)
+    for (; lane + 2 <= lanes; lane += 2) {
+        __m128i board = _mm_loadu_si128(reinterpret_cast<const __m128i*>(boards + lane));
+        __m128i found = _mm_or_si128(
+            _mm_or_si128(lines128<1>(board), lines128<ConnectFour::HEIGHT>(board)),
+            _mm_or_si128(lines128<ConnectFour::HEIGHT - 1>(board), lines128<ConnectFour::HEIGHT + 1>(board)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(wins + lane), found);
+    }
+#endif
+    for (; lane < lanes; ++lane) {
+        wins[lane] = ConnectFour::hasFour(boards[lane]);
+    }
+}
+
+int ConnectFourRollouts::play(const ConnectFour& state, int count, Xoshiro256& rng) {
+    if (count <= 0) return 0;
+    if (state.isGameOver()) return count * state.getReward(state.getCurrentPlayer());
+
+    const uint64_t start_position = state.getPlayerBoard(state.getCurrentPlayer());
+    const uint64_t start_mask = state.getOccupiedMask();
+
+    // Per lane: stones of the side to move, the occupied cells, and the
+    // stones of the side that just moved
+    alignas(32) uint64_t position[LANES];
+    alignas(32) uint64_t mask[LANES];
+    alignas(32) uint64_t moved[LANES];
+    alignas(32) uint64_t wins[LANES];
+
+    int total = 0;
+    for (int done = 0; done < count; done += LANES) {
+        int active = std::min(LANES, count - done);
+        for (int i = 0; i < active; ++i) {
+            position[i] = start_position;
+            mask[i] = start_mask;
+        }
+
+        // Lanes advance in lockstep, so they all have the same side to move
+        bool starter_moves = true;
+        while (active > 0) {
+            for (int i = 0; i < active; ++i) {
+                // Adding the bottom row carries into every column's lowest empty cell
+                uint64_t playable = ConnectFour::playableCells(mask[i]);
+                int choice = rng.below(bits::popcount(playable));
+                uint64_t move = nthSetBit(playable, choice);
+                moved[i] = position[i] | move;
+                mask[i] |= move;
+            }
+
+            findWins(moved, wins, active);
+
+            for (int i = 0; i < active;) {
+                if (!wins[i] && mask[i] != ConnectFour::BOARD_MASK) {
+                    position[i] = moved[i] ^ mask[i];
+                    ++i;
+                    continue;
+                }
+
+                // A full board is a draw
+                if (wins[i]) total += starter_moves ? 1 : -1;
+
+                --active;
+                position[i] = position[active];
+                mask[i] = mask[active];
+                moved[i] = moved[active];
+                wins[i] = wins[active];
+            }
+            starter_moves = !starter_moves;
+        }
+    }
+    return total;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "connect_four.h"
+#include "random.h"
+#include <cstdint>
+
+/**
+ * Batched random playouts for ConnectFour.
+ *
+ * Up to LANES games advance in lockstep, one ply per step, with their
+ * bitboards held as structure-of-arrays lanes. Finished games drop out by
+ * swapping with the last running lane, so the running lanes stay dense.
+ * The move choice is made per lane. The four-in-a-row test is the bulk of
+ * a step and runs over all lanes at once: with AVX2 or SSE2 when the
+ * compiler targets them, and as scalar code otherwise.
+ */
+class ConnectFourRollouts {
+public:
+    static constexpr int LANES = 16;
+
+    // Plays count uniformly random games from state and returns the sum of
+    // their rewards for state's side to move
+    static int play(const ConnectFour& state, int count, Xoshiro256& rng);
+
+    // Sets wins[i] to a non-zero value iff boards[i] holds four in a row
+    static void findWins(const uint64_t* boards, uint64_t* wins, int lanes);
+};
@@ -0,0 +1,158 @@
+#include "connect_four_solver.h"
+#include <algorithm>
+
+namespace {
+
+constexpr int CELLS = ConnectFour::ROWS * ConnectFour::COLS;
+
+// Columns from the center out, where most lines run through
+constexpr int COLUMN_ORDER[ConnectFour::COLS] = {3, 2, 4, 1, 5, 0, 6};
+
+// Nodes between deadline checks
+constexpr long long DEADLINE_CHECK_INTERVAL = 4096;
+
+} // namespace
+
+ConnectFourSolver::ConnectFourSolver(size_t table_size) {
+    size_t capacity = 1;
+    while (capacity < table_size) capacity <<= 1;
+    table_.assign(capacity, TableEntry{0, 0, NONE, 0, -1});
+    table_mask_ = capacity - 1;
+}
+
+void ConnectFourSolver::clearTable() {
+    std::fill(table_.begin(), table_.end(), TableEntry{0, 0, NONE, 0, -1});
+}
+
+ConnectFourSolver::Result ConnectFourSolver::solve(const ConnectFour& game,
+                                                   std::chrono::steady_clock::time_point deadline) {
+    nodes_ = 0;
+    timed_out_ = false;
+    deadline_ = deadline;
+
+    Result result;
+    if (game.isGameOver()) return result;
+
+    uint64_t position = game.getPlayerBoard(game.getCurrentPlayer());
+    uint64_t mask = game.getOccupiedMask();
+    int moves = game.getMoveCount();
+
+    for (int depth = 1; depth <= CELLS - moves; ++depth) {
+        hit_horizon_ = false;
+        int move = -1;
+        int score = negamax(position, mask, moves, depth, -WIN_SCORE, WIN_SCORE, &move);
+        if (timed_out_ && result.move >= 0) break;
+
+        result.move = move;
+        result.score = score;
+        result.depth = depth;
+        result.exact = !timed_out_ && (!hit_horizon_ || score != 0);
+        if (result.exact || timed_out_) break;
+    }
+
+    // Only a deadline inside the first iteration leaves no move
+    if (result.move < 0) {
+        uint64_t playable = ConnectFour::playableCells(mask);
+        result.move = bits::lowestBit(playable) / ConnectFour::HEIGHT;
+    }
+    return result;
+}
+
+int ConnectFourSolver::negamax(uint64_t position, uint64_t mask, int moves, int depth,
+                               int alpha, int beta, int* best_move) {
+    ++nodes_;
+    if (nodes_ % DEADLINE_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= deadline_) {
+        timed_out_ = true;
+    }
+    if (timed_out_) return 0;
+
+    uint64_t playable = ConnectFour::playableCells(mask);
+    uint64_t wins = ConnectFour::winningCells(position, mask) & playable;
+    if (wins) {
+        if (best_move) *best_move = bits::lowestBit(wins) / ConnectFour::HEIGHT;
+        return WIN_SCORE - (moves + 1);
+    }
+    if (moves == CELLS) return 0;
+
+    // Skip moves right below an opponent threat; a playable threat must be
+    // blocked, and two of them cannot be
+    uint64_t threats = ConnectFour::winningCells(position ^ mask, mask);
+    uint64_t forced = threats & playable;
+    uint64_t candidates = playable & ~(threats >> 1);
+    if (forced) {
+        candidates = (forced & (forced - 1)) ? 0 : candidates & forced;
+    }
+    if (!candidates) {
+        if (best_move) *best_move = bits::lowestBit(playable) / ConnectFour::HEIGHT;
+        return -(WIN_SCORE - (moves + 2));
+    }
+
+    if (depth == 0) {
+        hit_horizon_ = true;
+        return 0;
+    }
+
+    // Neither side can win before the next two stones are placed
+    int max_score = moves + 3 <= CELLS ? WIN_SCORE - (moves + 3) : 0;
+    int min_score = moves + 4 <= CELLS ? -(WIN_SCORE - (moves + 4)) : 0;
+    beta = std::min(beta, max_score);
+    alpha = std::max(alpha, min_score);
+    if (alpha >= beta && !best_move) return alpha;
+
+    // Entries searched at least this deep, or without a horizon, decide
+    // the node when their bound allows it
+    uint64_t key = position + mask;
+    int remaining = CELLS - moves;
+    TableEntry& entry = entryOf(key);
+    int table_move = -1;
+    if (entry.key == key && entry.bound != NONE) {
+        table_move = entry.move;
+        if (entry.depth >= std::min(depth, remaining) && !best_move) {
+            int score = entry.score;
+            if (entry.bound == EXACT || (entry.bound == LOWER && score >= beta) ||
+                (entry.bound == UPPER && score <= alpha)) {
+                if (entry.depth < remaining) hit_horizon_ = true;
+                return score;
+            }
+        }
+    }
+
+    bool outer_horizon = hit_horizon_;
+    hit_horizon_ = false;
+    int original_alpha = alpha;
+    int best_score = -WIN_SCORE;
+    int best_column = -1;
+
+    // The table's move first, then from the center out
+    for (int i = -1; i < ConnectFour::COLS; ++i) {
+        int col = i < 0 ? table_move : COLUMN_ORDER[i];
+        if (col < 0 || (i >= 0 && col == table_move)) continue;
+        uint64_t move = candidates & ConnectFour::columnMask(col);
+        if (!move) continue;
+
+        int score = -negamax(position ^ mask, mask | move, moves + 1, depth - 1, -beta, -alpha, nullptr);
+        if (timed_out_) return 0;
+        if (score > best_score) {
+            best_score = score;
+            best_column = col;
+        }
+        alpha = std::max(alpha, score);
+        if (alpha >= beta) break;
+    }
+
+    bool complete = !hit_horizon_;
+    hit_horizon_ = hit_horizon_ || outer_horizon;
+
+    entry.key = key;
+    entry.score = static_cast<int8_t>(best_score);
+    entry.bound = best_score <= original_alpha ? UPPER : best_score >= beta ? LOWER : EXACT;
+    entry.depth = static_cast<int8_t>(complete ? remaining : std::min(depth, remaining));
+    entry.move = static_cast<int8_t>(best_column);
+
+    if (best_move) *best_move = best_column;
+    return best_score;
+}
+
+ConnectFourSolver::TableEntry& ConnectFourSolver::entryOf(uint64_t key) {
+    return table_[((key * 0x9e3779b97f4a7c15ULL) >> 32) & table_mask_];
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "connect_four.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Exact negamax alpha-beta search for Connect Four.
+ *
+ * Positions are searched as a pair of bitboards: the stones of the side to
+ * move and the occupied cells. Immediate wins end a node, moves that let the
+ * opponent win at once are never tried, and the remaining moves are searched
+ * best move from the transposition table first, then from the center out.
+ *
+ * solve() deepens one ply at a time. Positions beyond the horizon count as
+ * draws, so a win or loss found at some depth is already the exact result,
+ * and a search that hit no horizon is exact too. The deepest completed
+ * iteration is used when the deadline passes first.
+ */
+class ConnectFourSolver {
+public:
+    // Score of a win for the side to move when the winning stone is the
+    // m-th on the board is WIN_SCORE - m; losses are negated, draws are 0
+    static constexpr int WIN_SCORE = ConnectFour::ROWS * ConnectFour::COLS + 1;
+
+    struct Result {
+        int move = -1;       // Best column, -1 if the game is over
+        int score = 0;       // For the side to move
+        bool exact = false;  // False when the deadline cut the search short
+        int depth = 0;       // Plies searched
+    };
+
+    // table_size entries, rounded up to a power of two
+    explicit ConnectFourSolver(size_t table_size = 1 << 20);
+
+    Result solve(const ConnectFour& game,
+                 std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+
+    // Nodes searched by the last solve()
+    long long getNodeCount() const { return nodes_; }
+    void clearTable();
+
+private:
+    enum Bound : uint8_t { NONE, EXACT, LOWER, UPPER };
+
+    struct TableEntry {
+        uint64_t key;
+        int8_t score;
+        uint8_t bound;
+        int8_t depth;  // Plies searched below the entry; the empty cells left means no horizon
+        int8_t move;
+    };
+
+    std::vector<TableEntry> table_;
+    uint64_t table_mask_;
+    long long nodes_ = 0;
+    bool hit_horizon_ = false;
+    bool timed_out_ = false;
+    std::chrono::steady_clock::time_point deadline_;
+
+    // Score of the side to move, whose stones are position, and its best
+    // column through move
+    int negamax(uint64_t position, uint64_t mask, int moves, int depth, int alpha, int beta, int* move);
+    TableEntry& entryOf(uint64_t key);
+};
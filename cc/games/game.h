@@ -1,5 +1,9 @@
 #pragma once
 
+#include "action_list.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <vector>
 #include <string>
 #include <memory>
@@ -12,18 +16,92 @@ public:
     virtual bool isGameOver() const = 0;
     virtual std::vector<int> getPossibleActions() const = 0;
     virtual void makeMove(int action) = 0;
+    // Reverts makeMove(action); action must be the last move made
+    virtual void unmakeMove(int action) = 0;
     virtual int getReward(int player) const = 0;
     virtual std::unique_ptr<Game> clone() const = 0;
     virtual void printState() const = 0;
     
+    // Allocation-free move generation; overwrites the contents of actions.
+    // The default goes through getPossibleActions() and should be overridden
+    // by games used in search.
+    virtual void generateActions(ActionList& actions) const {
+        actions.clear();
+        for (int action : getPossibleActions()) {
+            actions.push_back(action);
+        }
+    }
+    
     // Game state management
     virtual std::string serialize() const = 0;
     virtual bool deserialize(const std::string& state) = 0;
     
+    // Compact binary state: BINARY_FORMAT_VERSION, the side to move and the
+    // packed board, in at most MAX_BINARY_SIZE bytes. serializeBinary writes
+    // into buffer and returns the bytes written, or 0 if capacity is too
+    // small. deserializeBinary takes exactly those bytes, never allocates,
+    // and leaves the state unchanged when it returns false.
+    static constexpr uint8_t BINARY_FORMAT_VERSION = 1;
+    static constexpr size_t MAX_BINARY_SIZE = 16;
+    virtual size_t serializeBinary(uint8_t* buffer, size_t capacity) const = 0;
+    virtual bool deserializeBinary(const uint8_t* data, size_t size) = 0;
+    
+    // Position key: equal positions, including the side to move, have equal
+    // keys. The default hashes serialize(); games used with transposition
+    // tables should provide a cheap exact key.
+    virtual uint64_t getHash() const {
+        return std::hash<std::string>{}(serialize());
+    }
+    
     // Heuristic evaluation
     virtual double evaluatePosition() const = 0;
     virtual bool isWinningMove(int action) const = 0;
     
+    // Tactical moves of the side to move; overwrites both lists. wins gets
+    // the moves that win at once. When some moves would let the opponent win
+    // on its next move, because it threatens a line or the move opens one
+    // up, blocks gets the moves that do not; it is empty when no move is
+    // safe. The default tries each move on one clone; games used in search
+    // should detect threats directly.
+    virtual void generateTacticalMoves(ActionList& wins, ActionList& blocks) const {
+        ActionList actions;
+        ActionList replies;
+        generateActions(actions);
+        wins.clear();
+        blocks.clear();
+        
+        for (int action : actions) {
+            if (isWinningMove(action)) wins.push_back(action);
+        }
+        
+        auto probe = clone();
+        bool threatened = false;
+        for (int action : actions) {
+            probe->makeMove(action);
+            probe->generateActions(replies);
+            bool safe = true;
+            for (int reply : replies) {
+                if (probe->isWinningMove(reply)) {
+                    safe = false;
+                    break;
+                }
+            }
+            probe->unmakeMove(action);
+            
+            if (safe) {
+                blocks.push_back(action);
+            } else {
+                threatened = true;
+            }
+        }
+        if (!threatened) blocks.clear();
+    }
+    
+    // Perfect-play move of the side to move and its value: 1 for a win,
+    // 0 for a draw, -1 for a loss. Games small enough to tabulate return
+    // true for every unfinished position; the default knows none.
+    virtual bool lookupPerfectPlay(int& /*action*/, int& /*value*/) const { return false; }
+    
     // Game-specific information
     virtual int getCurrentPlayer() const = 0;
     virtual int getBoardSize() const = 0;
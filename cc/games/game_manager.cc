@@ -1,23 +1,50 @@
 #include "game_manager.h"
 #include "connect_four.h"
 #include "tic_tac_toe.h"
+#include "opening_book.h"
 #include <fstream>
 #include <iostream>
 #include <algorithm>
 
+namespace {
+
+// Written by build_opening_book; used when found in the working directory
+constexpr const char* OPENING_BOOK_FILE = "connect_four.book";
+
+// First bytes of binary saves
+constexpr char BINARY_SAVE_MAGIC[4] = {'G', 'S', 'A', 'V'};
+
+// Connect Four endgames below this many empty cells are solved exactly.
+// On 200 random positions with 19 empty cells the slowest solve took about
+// 12 ms at -O2; each added cell roughly doubles that, and the search runs
+// without a time limit here
+constexpr int EXACT_SOLVER_THRESHOLD = 20;
+
+} // namespace
+
 GameManager::GameManager(const std::string& game_type, int ai_player)
     : game_type(game_type), ai_player(ai_player) {
     game = createGame(game_type, 1);
     
     // Configure MCTS
-    MCTS::Config config;
+    MCTSConfig config;
     config.num_simulations = 1000;
     config.num_threads = std::thread::hardware_concurrency();
     config.use_heuristic = true;
     config.use_move_ordering = true;
+    config.use_unmake = true;
+    config.reuse_tree = true;
+    config.use_solver = true;
+    config.exact_solver_threshold = EXACT_SOLVER_THRESHOLD;
+    config.use_perfect_play = true;
     config.exploration_constant = 1.41;
     
-    ai = std::make_unique<MCTS>(config);
+    auto book = std::make_shared<OpeningBook>();
+    if (book->open(OPENING_BOOK_FILE)) {
+        config.opening_book = book;
+    }
+    
+    ai = createAI(game_type, config);
 }
 
 bool GameManager::makeMove(int action) {
@@ -62,9 +89,24 @@ void GameManager::printState() const {
     }
 }
 
-bool GameManager::saveGame(const std::string& filename) const {
+bool GameManager::saveGame(const std::string& filename, SaveFormat format) const {
     if (!game) return false;
     
+    if (format == SaveFormat::Binary) {
+        uint8_t state[Game::MAX_BINARY_SIZE];
+        size_t state_size = game->serializeBinary(state, sizeof(state));
+        if (state_size == 0) return false;
+        
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) return false;
+        file.write(BINARY_SAVE_MAGIC, sizeof(BINARY_SAVE_MAGIC));
+        file.put(static_cast<char>(game_type.size()));
+        file.write(game_type.data(), game_type.size());
+        file.put(static_cast<char>(state_size));
+        file.write(reinterpret_cast<const char*>(state), state_size);
+        return static_cast<bool>(file);
+    }
+    
     std::ofstream file(filename);
     if (!file.is_open()) return false;
     
@@ -78,23 +120,52 @@ bool GameManager::saveGame(const std::string& filename) const {
 }
 
 bool GameManager::loadGame(const std::string& filename) {
-    std::ifstream file(filename);
+    std::ifstream file(filename, std::ios::binary);
     if (!file.is_open()) return false;
     
-    // Read game type
-    std::string saved_type;
-    std::getline(file, saved_type);
+    // Binary saves start with the magic tag, text saves with the game type
+    char magic[sizeof(BINARY_SAVE_MAGIC)] = {};
+    bool binary = file.read(magic, sizeof(magic)) &&
+                  std::equal(magic, magic + sizeof(magic), BINARY_SAVE_MAGIC);
     
-    // Read game state
+    std::string saved_type;
     std::string state;
-    std::getline(file, state);
+    uint8_t binary_state[Game::MAX_BINARY_SIZE];
+    size_t binary_size = 0;
+    if (binary) {
+        int type_size = file.get();
+        if (type_size == EOF) return false;
+        saved_type.resize(type_size);
+        file.read(&saved_type[0], type_size);
+        int state_size = file.get();
+        if (!file || state_size == EOF || static_cast<size_t>(state_size) > sizeof(binary_state)) {
+            return false;
+        }
+        binary_size = state_size;
+        if (!file.read(reinterpret_cast<char*>(binary_state), binary_size)) return false;
+    } else {
+        file.clear();
+        file.seekg(0);
+        
+        // Read game type
+        std::getline(file, saved_type);
+        
+        // Read game state
+        std::getline(file, state);
+    }
     
     // Create new game of the correct type
     game = createGame(saved_type, 1);
     if (!game) return false;
     
+    // Switch the AI to the matching search instantiation
+    if (saved_type != game_type) {
+        ai = createAI(saved_type, ai->getConfig());
+        game_type = saved_type;
+    }
+    
     // Load the state
-    return game->deserialize(state);
+    return binary ? game->deserializeBinary(binary_state, binary_size) : game->deserialize(state);
 }
 
 int GameManager::getCurrentPlayer() const {
@@ -116,4 +187,15 @@ std::unique_ptr<Game> GameManager::createGame(const std::string& type, int start
         return std::make_unique<TicTacToe>(starting_player);
     }
     return nullptr;
+}
+
+std::unique_ptr<MCTSEngine> GameManager::createAI(const std::string& type, const MCTSConfig& config) {
+    // Searches specialized for the built-in games; anything else goes
+    // through the virtual Game interface
+    if (type == "connect_four") {
+        return std::make_unique<BasicMCTS<ConnectFour>>(config);
+    } else if (type == "tic_tac_toe") {
+        return std::make_unique<BasicMCTS<TicTacToe>>(config);
+    }
+    return std::make_unique<MCTS>(config);
 } 
\ No newline at end of file
@@ -16,8 +16,11 @@ public:
     bool isGameOver() const;
     void printState() const;
     
-    // Game state management
-    bool saveGame(const std::string& filename) const;
+    // Game state management. Text saves hold the game type and serialize()
+    // on two lines; binary saves hold a magic tag, the game type and
+    // serializeBinary(). loadGame reads either.
+    enum class SaveFormat { Text, Binary };
+    bool saveGame(const std::string& filename, SaveFormat format = SaveFormat::Text) const;
     bool loadGame(const std::string& filename);
     
     // Game information
@@ -27,9 +30,10 @@ public:
     
 private:
     std::unique_ptr<Game> game;
-    std::unique_ptr<MCTS> ai;
+    std::unique_ptr<MCTSEngine> ai;
     int ai_player;
     std::string game_type;
     
     std::unique_ptr<Game> createGame(const std::string& type, int starting_player);
+    std::unique_ptr<MCTSEngine> createAI(const std::string& type, const MCTSConfig& config);
 }; 
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "opening_book.h"
+#include "random.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char MAGIC[8] = {'C', '4', 'B', 'O', 'O', 'K', '\0', '\0'};
+
+} // namespace
+
+OpeningBook::~OpeningBook() {
+    close();
+}
+
+bool OpeningBook::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) return false;
+
+    const Header* header = static_cast<const Header*>(mapping);
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+        header->entry_size != sizeof(Entry) ||
+        (size - sizeof(Header)) % sizeof(Entry) != 0 ||
+        header->num_entries != (size - sizeof(Header)) / sizeof(Entry)) {
+        munmap(mapping, size);
+        return false;
+    }
+
+    mapping_ = mapping;
+    mapping_size_ = size;
+    entries_ = reinterpret_cast<const Entry*>(static_cast<const char*>(mapping) + sizeof(Header));
+    num_entries_ = header->num_entries;
+    return true;
+}
+
+void OpeningBook::close() {
+    if (mapping_) munmap(mapping_, mapping_size_);
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    entries_ = nullptr;
+    num_entries_ = 0;
+}
+
+const OpeningBook::Entry* OpeningBook::find(const ConnectFour& game) const {
+    if (num_entries_ == 0) return nullptr;
+    uint64_t key = keyOf(game);
+
+    // Interpolate the slot, then widen the range around it in doubling
+    // steps until it brackets the key
+    size_t guess = static_cast<size_t>((static_cast<unsigned __int128>(key) * num_entries_) >> 64);
+    size_t low = guess;
+    size_t high = guess + 1;
+    for (size_t step = 1; low > 0 && entries_[low].key > key; step <<= 1) {
+        low = low > step ? low - step : 0;
+    }
+    for (size_t step = 1; high < num_entries_ && entries_[high - 1].key < key; step <<= 1) {
+        high = std::min(num_entries_, high + step);
+    }
+
+    const Entry* entry = std::lower_bound(entries_ + low, entries_ + high, key,
+                                          [](const Entry& e, uint64_t k) { return e.key < k; });
+    return entry != entries_ + high && entry->key == key ? entry : nullptr;
+}
+
+uint64_t OpeningBook::keyOf(const ConnectFour& game) {
+    // mix64 is a bijection, so mixed keys stay exact
+    return mix64(game.getHash());
+}
+
+bool OpeningBook::write(const std::string& path, std::vector<Entry> entries) {
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.key < b.key; });
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.entry_size = sizeof(Entry);
+    header.num_entries = entries.size();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+    return static_cast<bool>(file);
+}
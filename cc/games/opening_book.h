@@ -0,0 +1,66 @@
+#pragma once
+#include "connect_four.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Read-only book of precomputed Connect Four moves, memory-mapped from a
+ * file written by build_opening_book.
+ *
+ * The file is a small header followed by fixed-size entries sorted by key.
+ * Keys are the position hashes passed through a bijective mixer, so they
+ * spread evenly over the 64-bit range: a lookup jumps straight to the
+ * interpolated slot and only scans a few neighbours. Opening the book maps
+ * the file without reading or parsing it; entries are probed in place.
+ * Files use the byte order of the machine that wrote them.
+ */
+class OpeningBook {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    struct Entry {
+        uint64_t key;          // keyOf() of the position
+        int16_t value;         // Expected reward of move for the side to move, in thousandths
+        int8_t move;           // Column to play
+        uint8_t depth;         // Stones on the board
+        uint32_t simulations;  // Search effort behind the entry
+    };
+    static_assert(sizeof(Entry) == 16, "Entries are stored as laid out in memory");
+
+    OpeningBook() = default;
+    ~OpeningBook();
+
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+
+    // Maps the book at path, replacing any open one; false if the file is
+    // missing or not a book of this version
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return entries_ != nullptr; }
+    size_t size() const { return num_entries_; }
+
+    // Entry for the position, or null when it is not in the book
+    const Entry* find(const ConnectFour& game) const;
+
+    static uint64_t keyOf(const ConnectFour& game);
+
+    // Writes entries, sorted by key, as a book file
+    static bool write(const std::string& path, std::vector<Entry> entries);
+
+private:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t entry_size;
+        uint64_t num_entries;
+    };
+
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    const Entry* entries_ = nullptr;
+    size_t num_entries_ = 0;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+// splitmix64 finalizer: a bijection that spreads every input bit over the
+// whole word. Used to seed generators and to mix exact but poorly
+// distributed position keys.
+inline uint64_t mix64(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * xoshiro256** pseudo-random generator.
+ *
+ * Small and fast enough to give every search thread its own instance, and
+ * fully determined by its 64-bit seed. Satisfies the standard
+ * UniformRandomBitGenerator requirements, so it also works with the
+ * <random> distributions.
+ */
+class Xoshiro256 {
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(uint64_t seed = 0) { this->seed(seed); }
+
+    // Expands seed into the full state with splitmix64
+    void seed(uint64_t seed) {
+        for (uint64_t& word : state) {
+            seed += 0x9e3779b97f4a7c15ULL;
+            word = mix64(seed);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform integer in [0, bound) for bound > 0, without modulo bias
+    // (Lemire's multiply-and-reject method)
+    uint32_t below(uint32_t bound) {
+        uint64_t product = (operator()() >> 32) * bound;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < bound) {
+            uint32_t threshold = (0u - bound) % bound;
+            while (low < threshold) {
+                product = (operator()() >> 32) * bound;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<uint32_t>(product >> 32);
+    }
+
+private:
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+};
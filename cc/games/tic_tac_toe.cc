@@ -2,54 +2,22 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
-#include <cassert>
 
 TicTacToe::TicTacToe(int starting_player)
-    : current_player(starting_player) {
+    : boards{0, 0}, current_player(starting_player) {
     if (starting_player != 1 && starting_player != 2) {
         throw std::invalid_argument("Starting player must be 1 or 2");
     }
-    board = std::vector<std::vector<int>>(BOARD_SIZE, std::vector<int>(BOARD_SIZE, EMPTY_CELL));
-}
-
-void TicTacToe::makeMove(int action) {
-    // Validate action bounds
-    if (action < 0 || action >= BOARD_SIZE * BOARD_SIZE) {
-        throw std::invalid_argument("Invalid move: position out of bounds");
-    }
-    
-    int row = action / BOARD_SIZE;
-    int col = action % BOARD_SIZE;
-    
-    // Validate position
-    if (!isValidPosition(row, col)) {
-        throw std::invalid_argument("Invalid move: position out of bounds");
-    }
-    
-    // Check if position is already taken
-    if (board[row][col] != EMPTY_CELL) {
-        throw std::invalid_argument("Invalid move: position already taken");
-    }
-    
-    // Make the move
-    board[row][col] = current_player;
-    current_player = (current_player == 1) ? 2 : 1;
-}
-
-bool TicTacToe::isGameOver() const {
-    return checkWin() || checkDraw();
 }
 
 std::vector<int> TicTacToe::getPossibleActions() const {
-    std::vector<int> actions;
-    actions.reserve(BOARD_SIZE * BOARD_SIZE);  // Pre-allocate for efficiency
+    uint16_t empty = ~occupied() & FULL_MASK;
     
-    for (int i = 0; i < BOARD_SIZE * BOARD_SIZE; ++i) {
-        int row = i / BOARD_SIZE;
-        int col = i % BOARD_SIZE;
-        if (isValidPosition(row, col) && board[row][col] == EMPTY_CELL) {
-            actions.push_back(i);
-        }
+    std::vector<int> actions;
+    actions.reserve(bits::popcount(empty));
+    while (empty) {
+        actions.push_back(bits::lowestBit(empty));
+        empty &= empty - 1;
     }
     return actions;
 }
@@ -58,10 +26,12 @@ void TicTacToe::printState() const {
     std::cout << "\n";
     for (int i = 0; i < BOARD_SIZE; ++i) {
         for (int j = 0; j < BOARD_SIZE; ++j) {
-            if (board[i][j] == EMPTY_CELL) {
-                std::cout << " " << (i * BOARD_SIZE + j) << " ";
+            int pos = i * BOARD_SIZE + j;
+            uint16_t cell = uint16_t(1) << pos;
+            if (!(occupied() & cell)) {
+                std::cout << " " << pos << " ";
             } else {
-                std::cout << " " << (board[i][j] == 1 ? "X" : "O") << " ";
+                std::cout << " " << ((boards[0] & cell) ? "X" : "O") << " ";
             }
             if (j < BOARD_SIZE - 1) std::cout << "|";
         }
@@ -76,140 +46,78 @@ void TicTacToe::printState() const {
 std::string TicTacToe::serialize() const {
     std::stringstream ss;
     ss << current_player << " ";
-    for (const auto& row : board) {
-        for (int cell : row) {
-            ss << cell << " ";
-        }
+    for (int pos = 0; pos < NUM_CELLS; ++pos) {
+        uint16_t cell = uint16_t(1) << pos;
+        ss << ((boards[0] & cell) ? 1 : (boards[1] & cell) ? 2 : EMPTY_CELL) << " ";
     }
     return ss.str();
 }
 
 bool TicTacToe::deserialize(const std::string& state) {
-    try {
-        std::stringstream ss(state);
-        ss >> current_player;
-        
-        if (current_player != 1 && current_player != 2) {
-            return false;
-        }
-        
-        for (auto& row : board) {
-            for (int& cell : row) {
-                ss >> cell;
-                if (cell != EMPTY_CELL && cell != 1 && cell != 2) {
-                    return false;
-                }
-            }
-        }
-        return true;
-    } catch (const std::exception&) {
-        return false;
-    }
-}
-
-bool TicTacToe::checkLine(const std::vector<std::vector<int>>& board, int start_row, int start_col, int delta_row, int delta_col) const {
-    // Validate start position
-    if (!isValidPosition(start_row, start_col)) {
+    std::stringstream ss(state);
+    int player;
+    if (!(ss >> player) || (player != 1 && player != 2)) {
         return false;
     }
     
-    int player = board[start_row][start_col];
-    if (player == EMPTY_CELL) return false;
-    
-    // Check the line
-    for (int i = 0; i < BOARD_SIZE; ++i) {
-        int row = start_row + i * delta_row;
-        int col = start_col + i * delta_col;
-        
-        // Validate each position in the line
-        if (!isValidPosition(row, col) || board[row][col] != player) {
+    uint16_t new_boards[2] = {0, 0};
+    for (int pos = 0; pos < NUM_CELLS; ++pos) {
+        int cell;
+        if (!(ss >> cell) || (cell != EMPTY_CELL && cell != 1 && cell != 2)) {
             return false;
         }
+        if (cell != EMPTY_CELL) {
+            new_boards[cell - 1] |= uint16_t(1) << pos;
+        }
     }
+    
+    boards[0] = new_boards[0];
+    boards[1] = new_boards[1];
+    current_player = player;
     return true;
 }
 
-bool TicTacToe::checkWin() const {
-    // Check rows
-    for (int i = 0; i < BOARD_SIZE; ++i) {
-        if (checkLine(board, i, 0, 0, 1)) return true;
-    }
-    
-    // Check columns
-    for (int j = 0; j < BOARD_SIZE; ++j) {
-        if (checkLine(board, 0, j, 1, 0)) return true;
-    }
-    
-    // Check diagonals
-    if (checkLine(board, 0, 0, 1, 1)) return true;
-    if (checkLine(board, 0, BOARD_SIZE - 1, 1, -1)) return true;
-    
-    return false;
-}
+namespace {
 
-bool TicTacToe::checkDraw() const {
-    for (const auto& row : board) {
-        for (int cell : row) {
-            if (cell == EMPTY_CELL) return false;
-        }
-    }
-    return true;
-}
+constexpr size_t BINARY_BOARD_BYTES = 3;  // 18 bits
+constexpr size_t BINARY_SIZE = 2 + BINARY_BOARD_BYTES;
 
-bool TicTacToe::isValidPosition(int row, int col) const {
-    return row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE;
-}
+} // namespace
 
-int TicTacToe::getWinner() const {
-    if (checkDraw()) return 0;
-    if (!checkWin()) return 0;
-    
-    // Check each line to find the winner
-    for (int i = 0; i < BOARD_SIZE; ++i) {
-        if (checkLine(board, i, 0, 0, 1)) return board[i][0];
-        if (checkLine(board, 0, i, 1, 0)) return board[0][i];
-    }
-    
-    if (checkLine(board, 0, 0, 1, 1)) return board[0][0];
-    if (checkLine(board, 0, BOARD_SIZE - 1, 1, -1)) return board[0][BOARD_SIZE - 1];
+size_t TicTacToe::serializeBinary(uint8_t* buffer, size_t capacity) const {
+    if (capacity < BINARY_SIZE) return 0;
     
-    return 0;
+    buffer[0] = BINARY_FORMAT_VERSION;
+    buffer[1] = static_cast<uint8_t>(current_player);
+    bits::storeBytes(buffer + 2, boards[0] | (uint32_t(boards[1]) << NUM_CELLS), BINARY_BOARD_BYTES);
+    return BINARY_SIZE;
 }
 
-int TicTacToe::getReward(int player) const {
-    if (!isGameOver()) return 0;
+bool TicTacToe::deserializeBinary(const uint8_t* data, size_t size) {
+    if (size != BINARY_SIZE || data[0] != BINARY_FORMAT_VERSION || (data[1] != 1 && data[1] != 2)) {
+        return false;
+    }
     
-    if (checkDraw()) return 0;
+    uint64_t packed = bits::loadBytes(data + 2, BINARY_BOARD_BYTES);
+    uint16_t first = packed & FULL_MASK;
+    uint16_t second = (packed >> NUM_CELLS) & FULL_MASK;
+    if ((packed >> (2 * NUM_CELLS)) != 0 || (first & second)) return false;
     
-    int winner = getWinner();
-    return (player == winner) ? 1 : -1;
+    boards[0] = first;
+    boards[1] = second;
+    current_player = data[1];
+    return true;
 }
 
 std::unique_ptr<Game> TicTacToe::clone() const {
-    auto clone = std::make_unique<TicTacToe>(current_player);
-    clone->board = board;
-    return clone;
+    return std::make_unique<TicTacToe>(*this);
 }
 
-double TicTacToe::evaluateLine(int start_row, int start_col, int delta_row, int delta_col) const {
-    int player_count = 0;
-    int opponent_count = 0;
-    int empty_count = 0;
-    
-    for (int i = 0; i < BOARD_SIZE; ++i) {
-        int row = start_row + i * delta_row;
-        int col = start_col + i * delta_col;
-        
-        if (!isValidPosition(row, col)) continue;
-        
-        if (board[row][col] == EMPTY_CELL) {
-            empty_count++;
-        } else if (board[row][col] == current_player) {
-            player_count++;
-        } else {
-            opponent_count++;
-        }
-    }
+double TicTacToe::evaluateLine(uint16_t line) const {
+    int opponent = (current_player == 1) ? 2 : 1;
+    int player_count = bits::popcount(boards[current_player - 1] & line);
+    int opponent_count = bits::popcount(boards[opponent - 1] & line);
+    int empty_count = BOARD_SIZE - player_count - opponent_count;
     
     // Scoring based on line composition
     if (player_count == 2 && empty_count == 2) return 0.1;    // Two in a row
@@ -226,72 +134,97 @@ double TicTacToe::evaluatePosition() const {
     double score = 0.0;
     
     // Evaluate all possible lines
-    for (int i = 0; i < BOARD_SIZE; ++i) {
-        score += evaluateLine(i, 0, 0, 1);    // Rows
-        score += evaluateLine(0, i, 1, 0);    // Columns
+    for (uint16_t line : WIN_MASKS) {
+        score += evaluateLine(line);
     }
-    score += evaluateLine(0, 0, 1, 1);        // Main diagonal
-    score += evaluateLine(0, BOARD_SIZE - 1, 1, -1);  // Anti-diagonal
     
     return score;
 }
 
-bool TicTacToe::isWinningMove(int action) const {
-    // Validate action bounds
-    if (action < 0 || action >= BOARD_SIZE * BOARD_SIZE) {
-        return false;
-    }
-    
-    int row = action / BOARD_SIZE;
-    int col = action % BOARD_SIZE;
-    
-    // Validate position
-    if (!isValidPosition(row, col) || board[row][col] != EMPTY_CELL) {
-        return false;
-    }
-    
-    // Create a temporary board to test the move
-    std::vector<std::vector<int>> temp_board = board;
-    temp_board[row][col] = current_player;
-    
-    // Check if this move would win
-    bool is_winning = false;
+int TicTacToe::getBoardSize() const {
+    return BOARD_SIZE;
+}
+
+std::string TicTacToe::getGameName() const {
+    return "Tic Tac Toe";
+}
+
+bool TicTacToe::lookupPerfectPlay(int& action, int& value) const {
+    if (isGameOver()) return false;
     
-    // Check rows
-    for (int i = 0; i < BOARD_SIZE; ++i) {
-        if (checkLine(temp_board, i, 0, 0, 1)) {
-            is_winning = true;
-            break;
-        }
+    const PerfectPlayEntry& entry = perfectPlayTable()[perfectPlayKey(boards[0], boards[1], current_player)];
+    action = entry.move;
+    value = (entry.score > 0) - (entry.score < 0);
+    return true;
+}
+
+int TicTacToe::perfectPlayKey(uint16_t first, uint16_t second, int player) {
+    int key = 0;
+    for (int pos = NUM_CELLS - 1; pos >= 0; --pos) {
+        key = key * 3 + ((first >> pos) & 1) + 2 * ((second >> pos) & 1);
     }
-    
-    // Check columns
-    if (!is_winning) {
-        for (int j = 0; j < BOARD_SIZE; ++j) {
-            if (checkLine(temp_board, 0, j, 1, 0)) {
-                is_winning = true;
-                break;
+    return key * 2 + player - 1;
+}
+
+const std::vector<TicTacToe::PerfectPlayEntry>& TicTacToe::perfectPlayTable() {
+    // Every encoding is solved, reachable or not, so deserialized boards
+    // are covered too
+    static const std::vector<PerfectPlayEntry> table = [] {
+        int num_boards = 1;
+        for (int pos = 0; pos < NUM_CELLS; ++pos) num_boards *= 3;
+        
+        std::vector<PerfectPlayEntry> entries(2 * num_boards, PerfectPlayEntry{0, -2});
+        for (int board = 0; board < num_boards; ++board) {
+            uint16_t first = 0;
+            uint16_t second = 0;
+            for (int pos = 0, digits = board; pos < NUM_CELLS; ++pos, digits /= 3) {
+                if (digits % 3 == 1) first |= uint16_t(1) << pos;
+                if (digits % 3 == 2) second |= uint16_t(1) << pos;
             }
+            solvePerfectPlay(first, second, 1, entries);
+            solvePerfectPlay(first, second, 2, entries);
         }
+        return entries;
+    }();
+    return table;
+}
+
+int TicTacToe::solvePerfectPlay(uint16_t first, uint16_t second, int player,
+                                std::vector<PerfectPlayEntry>& table) {
+    PerfectPlayEntry& entry = table[perfectPlayKey(first, second, player)];
+    if (entry.move != -2) return entry.score;
+    
+    uint16_t taken = first | second;
+    if (hasLine(first) || hasLine(second) || taken == FULL_MASK) {
+        entry = PerfectPlayEntry{0, -1};
+        return 0;
     }
     
-    // Check diagonals
-    if (!is_winning) {
-        if (checkLine(temp_board, 0, 0, 1, 1)) is_winning = true;
-        if (!is_winning && checkLine(temp_board, 0, BOARD_SIZE - 1, 1, -1)) is_winning = true;
+    int marks = bits::popcount(taken) + 1;
+    int best_score = -(NUM_CELLS + 1);
+    int best_move = -1;
+    for (uint16_t empty = ~taken & FULL_MASK; empty; empty &= empty - 1) {
+        int move = bits::lowestBit(empty);
+        uint16_t cell = uint16_t(1) << move;
+        uint16_t own = (player == 1 ? first : second) | cell;
+        
+        int score;
+        if (marks == NUM_CELLS) {
+            // getReward scores a full board as a draw
+            score = 0;
+        } else if (hasLine(own)) {
+            score = NUM_CELLS + 1 - marks;
+        } else if (player == 1) {
+            score = -solvePerfectPlay(own, second, 2, table);
+        } else {
+            score = -solvePerfectPlay(first, own, 1, table);
+        }
+        if (score > best_score) {
+            best_score = score;
+            best_move = move;
+        }
     }
     
-    return is_winning;
-}
-
-int TicTacToe::getCurrentPlayer() const {
-    return current_player;
-}
-
-int TicTacToe::getBoardSize() const {
-    return BOARD_SIZE;
+    entry = PerfectPlayEntry{static_cast<int8_t>(best_score), static_cast<int8_t>(best_move)};
+    return best_score;
 }
-
-std::string TicTacToe::getGameName() const {
-    return "Tic Tac Toe";
-} 
\ No newline at end of file
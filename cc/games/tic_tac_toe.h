@@ -1,9 +1,13 @@
 #pragma once
 
 #include "game.h"
+#include "bit_utils.h"
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <memory>
+#include <stdexcept>
 
 /**
  * TicTacToe game implementation.
@@ -13,23 +17,35 @@
  *   3 | 4 | 5
  *  ---+---+---
  *   6 | 7 | 8
+ *
+ * The state is packed into one 9-bit mask per player, bit i standing for
+ * position i, plus the side to move.
  */
-class TicTacToe : public Game {
+class TicTacToe final : public Game {
 public:
     explicit TicTacToe(int starting_player = 1);
     ~TicTacToe() override = default;
     
     // Game interface implementation
     void makeMove(int action) override;
+    void unmakeMove(int action) override;
     bool isGameOver() const override;
     std::vector<int> getPossibleActions() const override;
+    void generateActions(ActionList& actions) const override;
     void printState() const override;
     std::string serialize() const override;
     bool deserialize(const std::string& state) override;
+    // Both 9-bit boards in one 18-bit field
+    size_t serializeBinary(uint8_t* buffer, size_t capacity) const override;
+    bool deserializeBinary(const uint8_t* data, size_t size) override;
+    uint64_t getHash() const override;
     int getReward(int player) const override;
     std::unique_ptr<Game> clone() const override;
     double evaluatePosition() const override;
     bool isWinningMove(int action) const override;
+    void generateTacticalMoves(ActionList& wins, ActionList& blocks) const override;
+    // From a minimax table of every board, built on first use
+    bool lookupPerfectPlay(int& action, int& value) const override;
     int getCurrentPlayer() const override;
     int getBoardSize() const override;
     std::string getGameName() const override;
@@ -37,15 +53,176 @@ public:
     
 private:
     static constexpr int BOARD_SIZE = 3;
+    static constexpr int NUM_CELLS = BOARD_SIZE * BOARD_SIZE;
+    static constexpr uint16_t FULL_MASK = (1 << NUM_CELLS) - 1;
     static constexpr int EMPTY_CELL = 0;
-    
-    std::vector<std::vector<int>> board;
+
+    // Rows, columns and both diagonals
+    static constexpr std::array<uint16_t, 8> WIN_MASKS = {
+        0x007, 0x038, 0x1C0,  // rows
+        0x049, 0x092, 0x124,  // columns
+        0x111, 0x054          // diagonals
+    };
+
+    // Minimax result of one board and side to move, under getReward's
+    // rules. A win for the side to move when the winning mark is the m-th
+    // on the board scores NUM_CELLS + 1 - m, so faster wins score higher;
+    // losses are negated.
+    struct PerfectPlayEntry {
+        int8_t score;
+        int8_t move;  // -1 for finished boards
+    };
+
+    uint16_t boards[2];  // positions held by player 1 and player 2
     int current_player;
-    
+
     // Helper methods
+    static bool hasLine(uint16_t board);
+    // Empty cells that would complete a line of board
+    static uint16_t winningCells(uint16_t board, uint16_t occupied);
+    static void appendCells(ActionList& actions, uint16_t cells);
+    uint16_t occupied() const { return boards[0] | boards[1]; }
     bool checkWin() const;
     bool checkDraw() const;
-    bool checkLine(const std::vector<std::vector<int>>& board, int start_row, int start_col, int delta_row, int delta_col) const;
-    bool isValidPosition(int row, int col) const;
-    double evaluateLine(int start_row, int start_col, int delta_row, int delta_col) const;
-}; 
\ No newline at end of file
+    double evaluateLine(uint16_t line) const;
+
+    // One base-3 digit per cell, times two for the side to move
+    static int perfectPlayKey(uint16_t first, uint16_t second, int player);
+    static const std::vector<PerfectPlayEntry>& perfectPlayTable();
+    static int solvePerfectPlay(uint16_t first, uint16_t second, int player,
+                                std::vector<PerfectPlayEntry>& table);
+};
+
+// Hot paths, inline for BasicMCTS<TicTacToe>
+
+inline void TicTacToe::makeMove(int action) {
+    // Validate action bounds
+    if (action < 0 || action >= NUM_CELLS) {
+        throw std::invalid_argument("Invalid move: position out of bounds");
+    }
+    
+    uint16_t cell = uint16_t(1) << action;
+    
+    // Check if position is already taken
+    if (occupied() & cell) {
+        throw std::invalid_argument("Invalid move: position already taken");
+    }
+    
+    // Make the move
+    boards[current_player - 1] |= cell;
+    current_player = (current_player == 1) ? 2 : 1;
+}
+
+inline void TicTacToe::unmakeMove(int action) {
+    if (action < 0 || action >= NUM_CELLS) {
+        throw std::invalid_argument("Invalid undo: position out of bounds");
+    }
+    
+    // The position must hold a mark of the player who moved last
+    int previous_player = (current_player == 1) ? 2 : 1;
+    uint16_t cell = uint16_t(1) << action;
+    if (!(boards[previous_player - 1] & cell)) {
+        throw std::invalid_argument("Invalid undo: position not held by previous player");
+    }
+    
+    boards[previous_player - 1] &= ~cell;
+    current_player = previous_player;
+}
+
+inline bool TicTacToe::isGameOver() const {
+    return checkWin() || checkDraw();
+}
+
+inline void TicTacToe::generateActions(ActionList& actions) const {
+    uint16_t empty = ~occupied() & FULL_MASK;
+    
+    actions.clear();
+    while (empty) {
+        actions.push_back(bits::lowestBit(empty));
+        empty &= empty - 1;
+    }
+}
+
+inline bool TicTacToe::hasLine(uint16_t board) {
+    for (uint16_t line : WIN_MASKS) {
+        if ((board & line) == line) return true;
+    }
+    return false;
+}
+
+inline bool TicTacToe::checkWin() const {
+    return hasLine(boards[0]) || hasLine(boards[1]);
+}
+
+inline bool TicTacToe::checkDraw() const {
+    return occupied() == FULL_MASK;
+}
+
+inline int TicTacToe::getWinner() const {
+    if (checkDraw()) return 0;
+    if (hasLine(boards[0])) return 1;
+    if (hasLine(boards[1])) return 2;
+    return 0;
+}
+
+inline int TicTacToe::getReward(int player) const {
+    if (!isGameOver()) return 0;
+    
+    if (checkDraw()) return 0;
+    
+    int winner = getWinner();
+    return (player == winner) ? 1 : -1;
+}
+
+inline bool TicTacToe::isWinningMove(int action) const {
+    // Validate action bounds
+    if (action < 0 || action >= NUM_CELLS) {
+        return false;
+    }
+    
+    uint16_t cell = uint16_t(1) << action;
+    if (occupied() & cell) {
+        return false;
+    }
+    
+    // Check if this move would complete a line
+    return hasLine(boards[current_player - 1] | cell);
+}
+
+inline uint16_t TicTacToe::winningCells(uint16_t board, uint16_t occupied) {
+    uint16_t cells = 0;
+    for (uint16_t line : WIN_MASKS) {
+        // Lines missing exactly one cell
+        uint16_t missing = line & ~board;
+        if (missing && !(missing & (missing - 1))) cells |= missing;
+    }
+    return cells & ~occupied;
+}
+
+inline void TicTacToe::generateTacticalMoves(ActionList& wins, ActionList& blocks) const {
+    wins.clear();
+    blocks.clear();
+    appendCells(wins, winningCells(boards[current_player - 1], occupied()));
+
+    // Two threats cannot both be blocked
+    uint16_t threats = winningCells(boards[2 - current_player], occupied());
+    if (threats && !(threats & (threats - 1))) {
+        appendCells(blocks, threats);
+    }
+}
+
+inline void TicTacToe::appendCells(ActionList& actions, uint16_t cells) {
+    while (cells) {
+        actions.push_back(bits::lowestBit(cells));
+        cells &= cells - 1;
+    }
+}
+
+inline uint64_t TicTacToe::getHash() const {
+    return boards[0] | (uint64_t(boards[1]) << NUM_CELLS) |
+           (uint64_t(current_player) << (2 * NUM_CELLS));
+}
+
+inline int TicTacToe::getCurrentPlayer() const {
+    return current_player;
+}
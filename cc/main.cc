@@ -1,14 +1,8 @@
 #include "games/game_manager.h"
 #include <iostream>
 #include <string>
-#include <random>
 
 int main() {
-    // Initialize random number generator
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::srand(gen());
-    
     // Game selection
     std::cout << "Select a game to play:" << std::endl;
     std::cout << "1. Connect Four" << std::endl;
@@ -0,0 +1,87 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Bump allocator for objects that are released together.
+ *
+ * Objects are constructed back to back in large blocks and are never freed
+ * one by one: clear() or the destructor drops every block at once, running
+ * destructors only when T has a non-trivial one. An arena is not
+ * thread-safe; concurrent writers should each use their own.
+ */
+template <typename T>
+class Arena {
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 1024;
+
+    explicit Arena(size_t block_size = DEFAULT_BLOCK_SIZE)
+        : block_size_(std::max<size_t>(1, block_size)) {}
+    ~Arena() { clear(); }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        Block& block = reserve(1);
+        T* object = new (block.data + block.used) T(std::forward<Args>(args)...);
+        ++block.used;
+        ++size_;
+        return object;
+    }
+
+    // Constructs count adjacent objects from the same arguments
+    template <typename... Args>
+    T* createRange(size_t count, const Args&... args) {
+        Block& block = reserve(count);
+        T* range = block.data + block.used;
+        for (size_t i = 0; i < count; ++i) {
+            new (range + i) T(args...);
+            ++block.used;
+            ++size_;
+        }
+        return range;
+    }
+
+    void clear() {
+        for (auto& block : blocks_) {
+            if (!std::is_trivially_destructible<T>::value) {
+                for (size_t i = 0; i < block.used; ++i) {
+                    block.data[i].~T();
+                }
+            }
+            std::allocator<T>().deallocate(block.data, block.capacity);
+        }
+        blocks_.clear();
+        size_ = 0;
+    }
+
+    // Number of live objects
+    size_t size() const { return size_; }
+
+private:
+    struct Block {
+        T* data;
+        size_t capacity;
+        size_t used;
+    };
+
+    std::vector<Block> blocks_;
+    size_t block_size_;
+    size_t size_ = 0;
+
+    // Block with room for count adjacent objects
+    Block& reserve(size_t count) {
+        if (blocks_.empty() || blocks_.back().capacity - blocks_.back().used < count) {
+            size_t capacity = std::max(block_size_, count);
+            blocks_.push_back({std::allocator<T>().allocate(capacity), capacity, 0});
+        }
+        return blocks_.back();
+    }
+};
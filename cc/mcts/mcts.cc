@@ -1,204 +1,666 @@
 #include "mcts.h"
+#include "../games/connect_four.h"
+#include "../games/connect_four_solver.h"
+#include "../games/connect_four_rollouts.h"
+#include "../games/opening_book.h"
+#include "../games/tic_tac_toe.h"
+#include <chrono>
 #include <cmath>
+#include <string>
 #include <algorithm>
 #include <random>
 #include <thread>
-#include <mutex>
+#include <type_traits>
 
-MCTS::MCTS(const Config& config) : config_(config) {}
+namespace {
 
-int MCTS::selectAction(Game* game) {
-    if (!game) return -1;
+// Heap copy of a state: clone() for the abstract Game, copy construction
+// for concrete game types
+template <typename GameT>
+std::unique_ptr<GameT> copyState(const GameT& state) {
+    if constexpr (std::is_abstract<GameT>::value) {
+        return state.clone();
+    } else {
+        return std::make_unique<GameT>(state);
+    }
+}
+
+// Spin lock over a node's expanding flag; expansions are short. Time spent
+// waiting for another thread is added to wait_ns.
+class ExpansionGuard {
+public:
+    ExpansionGuard(std::atomic<bool>& flag, long long& wait_ns) : flag_(flag) {
+        if (!flag_.exchange(true, std::memory_order_acquire)) return;
+        
+        // Only contended locks are timed
+        PhaseTimer timer;
+        while (flag_.exchange(true, std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        timer.lap(wait_ns);
+    }
+    ~ExpansionGuard() { flag_.store(false, std::memory_order_release); }
+
+private:
+    std::atomic<bool>& flag_;
+};
+
+// game as a Connect Four position, if it is one
+template <typename GameT>
+const ConnectFour* asConnectFour(const GameT& game) {
+    if constexpr (std::is_same<GameT, ConnectFour>::value) {
+        return &game;
+    } else if constexpr (std::is_same<GameT, Game>::value) {
+        return dynamic_cast<const ConnectFour*>(&game);
+    } else {
+        return nullptr;
+    }
+}
+
+// Book entry of game when it is a Connect Four position
+template <typename GameT>
+const OpeningBook::Entry* findBookEntry(const OpeningBook& book, const GameT& game) {
+    auto connect_four = asConnectFour(game);
+    return connect_four ? book.find(*connect_four) : nullptr;
+}
+
+// Equal keys are confirmed on the packed boards, so a key collision never
+// matches another position
+template <typename GameT>
+bool samePosition(const GameT& a, const GameT& b) {
+    if (a.getHash() != b.getHash()) return false;
+    uint8_t a_board[Game::MAX_BINARY_SIZE];
+    uint8_t b_board[Game::MAX_BINARY_SIZE];
+    size_t size = a.serializeBinary(a_board, sizeof(a_board));
+    return size == b.serializeBinary(b_board, sizeof(b_board)) && std::equal(a_board, a_board + size, b_board);
+}
+
+template <typename GameT>
+int countActions(const GameT& state) {
+    ActionList actions;
+    state.generateActions(actions);
+    return actions.size();
+}
+
+} // namespace
+
+template <typename GameT>
+BasicMCTS<GameT>::BasicMCTS(const Config& config) {
+    setConfig(config);
+}
+
+template <typename GameT>
+BasicMCTS<GameT>::~BasicMCTS() = default;
+
+template <typename GameT>
+void BasicMCTS<GameT>::setConfig(const Config& config) {
+    config_ = config;
+    tree_.reset();
+    
+    // A new seed also takes a pool seeded from it
+    pool_.reset();
+    if (config_.seed != 0) {
+        base_seed_ = config_.seed;
+    } else if (config_.deterministic) {
+        base_seed_ = DETERMINISTIC_SEED;
+    } else {
+        std::random_device rd;
+        base_seed_ = (uint64_t(rd()) << 32) ^ rd();
+    }
+    rng_.seed(base_seed_);
+}
+
+template <typename GameT>
+int BasicMCTS<GameT>::selectAction(Game* game) {
+    auto typed_game = dynamic_cast<GameT*>(game);
+    if (!typed_game) return -1;
+    
+    return search(typed_game);
+}
+
+template <typename GameT>
+int BasicMCTS<GameT>::search(GameT* game) {
+    // The budget covers the whole call
+    auto start = std::chrono::steady_clock::now();
+    deadline_ = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(config_.time_limit_ms));
+    claimed_.store(0);
+    simulations_.store(0);
+    stop_requested_.store(false);
+    stats_ = SearchStats();
+    counters_.clear();
+    
+    ++searches_;
+    if (config_.deterministic) {
+        rng_.seed(taskSeed(0));
+    }
     
+    // Every outcome, including the moves played without searching, ends
+    // with complete statistics
+    int action = chooseAction(game);
+    collectStats(start);
+    return action;
+}
+
+template <typename GameT>
+int BasicMCTS<GameT>::chooseAction(GameT* game) {
     // Check if game is over
     if (game->isGameOver()) return -1;
     
     // Get valid actions
-    auto valid_actions = game->getPossibleActions();
+    ActionList valid_actions;
+    game->generateActions(valid_actions);
     if (valid_actions.empty()) return -1;
     
-    // First, check for winning moves
-    for (int action : valid_actions) {
-        if (game->isWinningMove(action)) {
-            return action;
+    // Tabulated positions need no search
+    int perfect_action;
+    int perfect_value;
+    if (config_.use_perfect_play && game->lookupPerfectPlay(perfect_action, perfect_value)) {
+        stats_.value = perfect_value;
+        stats_.solved = true;
+        return perfect_action;
+    }
+    
+    // Win at once if possible, and play the only move that stops the
+    // opponent from winning on its next move
+    ActionList wins;
+    ActionList blocks;
+    game->generateTacticalMoves(wins, blocks);
+    if (!wins.empty()) {
+        stats_.value = 1.0;
+        stats_.solved = true;
+        return wins[0];
+    }
+    if (blocks.size() == 1) return blocks[0];
+    
+    // Book positions were searched offline
+    if (config_.opening_book) {
+        auto entry = findBookEntry(*config_.opening_book, *game);
+        if (entry && valid_actions.contains(entry->move)) {
+            stats_.value = entry->value / 1000.0;
+            return entry->move;
         }
     }
     
-    // Then, check for blocking moves
-    for (int action : valid_actions) {
-        auto clone = game->clone();
-        if (!clone) continue;
-        
-        try {
-            clone->makeMove(action);
-            bool blocks = false;
-            for (int opponent_move : clone->getPossibleActions()) {
-                if (clone->isWinningMove(opponent_move)) {
-                    blocks = true;
-                    break;
-                }
-            }
-            if (blocks) {
-                return action;
-            }
-        } catch (const std::exception&) {
-            continue;
+    // Endgames small enough are solved exactly. A solve cut short by the
+    // deadline has spent the budget, so its deepest completed iteration
+    // is played rather than a search without simulations
+    if (config_.exact_solver_threshold > 0) {
+        auto connect_four = asConnectFour(*game);
+        if (connect_four && ConnectFour::ROWS * ConnectFour::COLS - connect_four->getMoveCount() <
+                                config_.exact_solver_threshold) {
+            if (!exact_solver_) exact_solver_ = std::make_unique<ConnectFourSolver>();
+            auto deadline = config_.time_limit_ms > 0 ? deadline_ : std::chrono::steady_clock::time_point::max();
+            auto result = exact_solver_->solve(*connect_four, deadline);
+            stats_.value = (result.score > 0) - (result.score < 0);
+            stats_.solved = result.exact;
+            return result.move;
         }
     }
     
     // If no winning or blocking moves, use MCTS
-    auto root = std::make_unique<MCTSNode>(game->clone());
-    if (!root) return -1;
+    std::vector<ActionStats> root_stats;
+    
+    // A shared tree depends on thread timing, so deterministic tree search
+    // grows private trees like root mode
+    using Mode = Config::SearchMode;
+    bool root_parallel = config_.num_threads > 1 &&
+        (config_.search_mode == Mode::Root || (config_.deterministic && config_.search_mode == Mode::Tree));
     
-    if (config_.num_threads > 1) {
-        parallelSimulate(root.get(), config_.num_threads);
+    if (root_parallel) {
+        // Private trees are not kept between moves
+        tree_.reset();
+        stats_.nodes_allocated = rootParallelSimulate(*game, root_stats);
     } else {
-        for (int i = 0; i < config_.num_simulations; ++i) {
-            auto node = select(root.get());
-            if (!node) continue;
-            
-            node = expand(node);
-            if (!node) continue;
-            
-            int reward = simulate(node);
-            backpropagate(node, reward);
+        bool tree_parallel = config_.num_threads > 1 && config_.search_mode == Config::SearchMode::Tree;
+        int num_workers = tree_parallel ? getPool().size() : 1;
+        
+        // Continue from the previous tree when it contains this position
+        std::unique_ptr<Tree> tree = std::move(tree_);
+        if (!tree || !config_.reuse_tree || !rerootTree(*tree, *game, num_workers)) {
+            tree = std::make_unique<Tree>();
+            initTree(*tree, *game, num_workers, config_.max_nodes);
+        }
+        
+        if (config_.num_threads > 1 && config_.search_mode == Config::SearchMode::Leaf) {
+            leafParallelSimulate(*tree);
+        } else if (tree_parallel) {
+            parallelSimulate(*tree);
+        } else {
+            counters_.assign(1, SearchCounters());
+            auto worker = makeWorker(*game, rng_, *tree, 0, counters_[0]);
+            while (!outOfBudget(*tree) && claimSimulations(1) > 0) {
+                runSimulation(tree->root, worker);
+            }
+        }
+        
+        accumulateRootStats(tree->root, root_stats);
+        stats_.nodes_allocated = tree->num_nodes.load(std::memory_order_relaxed);
+        if (config_.reuse_tree) {
+            tree_ = std::move(tree);
         }
     }
 
-    // Select best action
+    // Select best action: proven wins first, the fastest one, and proven
+    // losses last, the slowest one
     int best_action = -1;
     double best_value = -1e9;
+    double best_reward = 0.0;
+    int num_proven = 0;
+    bool proven_win = false;
     
-    for (const auto& child : root->children) {
-        if (!child) continue;
-        
-        std::lock_guard<std::mutex> lock(child->mutex);
-        if (child->stats[0] > 0) {
-            double value = child->stats[1] / child->stats[0];
-            if (value > best_value) {
-                best_value = value;
-                best_action = child->parent_action;
+    for (const auto& stats : root_stats) {
+        double value;
+        double reward;
+        if (stats.proof != 0) {
+            int distance = MCTSProof::distance(stats.proof);
+            switch (MCTSProof::result(stats.proof)) {
+                case MCTSProof::Win:
+                    reward = 1.0;
+                    value = 2.0 + 1.0 / (1 + distance);
+                    break;
+                case MCTSProof::Loss:
+                    reward = -1.0;
+                    value = -2.0 - 1.0 / (1 + distance);
+                    break;
+                default:
+                    reward = 0.0;
+                    value = 0.0;
+                    break;
             }
+            proven_win = proven_win || MCTSProof::result(stats.proof) == MCTSProof::Win;
+            ++num_proven;
+        } else if (stats.visits > 0) {
+            value = static_cast<double>(stats.wins) / stats.visits;
+            reward = value;
+        } else {
+            continue;
+        }
+        
+        if (value > best_value) {
+            best_value = value;
+            best_reward = reward;
+            best_action = stats.action;
         }
     }
+    stats_.value = best_reward;
+    stats_.solved = proven_win || num_proven == valid_actions.size();
 
     // Validate the selected action
-    if (best_action < 0 || std::find(valid_actions.begin(), valid_actions.end(), best_action) == valid_actions.end()) {
+    if (best_action < 0 || !valid_actions.contains(best_action)) {
         // If no valid action found, select a random valid action
-        best_action = valid_actions[rand() % valid_actions.size()];
+        best_action = valid_actions[rng_.below(valid_actions.size())];
     }
 
     return best_action;
 }
 
-MCTSNode* MCTS::select(MCTSNode* node) {
-    if (!node || !node->game_state) return nullptr;
+template <typename GameT>
+void BasicMCTS<GameT>::initTree(Tree& tree, const GameT& game, int num_workers, size_t max_nodes) const {
+    for (int i = 0; i < num_workers; ++i) {
+        tree.arenas.push_back(std::make_unique<TreeArena>());
+    }
+    tree.max_nodes = max_nodes;
+    
+    TreeArena& arena = *tree.arenas[0];
+    tree.root = arena.nodes.create();
+    tree.num_nodes.fetch_add(1, std::memory_order_relaxed);
+    tree.root->game_state = storeState(arena, game);
+    tree.root->num_actions = countActions(game);
+    
+    if (config_.use_transpositions) {
+        tree.table = std::make_unique<TranspositionTable<Node>>(config_.transposition_table_size);
+        tree.root->hash = game.getHash();
+        tree.table->insert(tree.root);
+    }
+}
+
+template <typename GameT>
+typename BasicMCTS<GameT>::Node* BasicMCTS<GameT>::createChildren(Tree& tree, TreeArena& arena, Node* parent) {
+    tree.num_nodes.fetch_add(parent->num_actions, std::memory_order_relaxed);
+    return arena.nodes.createRange(parent->num_actions);
+}
+
+template <typename GameT>
+GameT* BasicMCTS<GameT>::storeState(TreeArena& arena, const GameT& state) {
+    if constexpr (std::is_abstract<GameT>::value) {
+        return arena.states.create(state.clone())->get();
+    } else {
+        return arena.states.create(state);
+    }
+}
+
+template <typename GameT>
+bool BasicMCTS<GameT>::rerootTree(Tree& tree, const GameT& game, int num_workers) const {
+    if (!tree.root || !tree.root->game_state) return false;
+    if (tree.max_nodes > 0 && tree.num_nodes.load(std::memory_order_relaxed) >= tree.max_nodes) {
+        return false;
+    }
+    
+    auto state = copyState(*tree.root->game_state);
+    if (!state) return false;
+    Node* match = findPosition(tree.root, *state, game, MAX_REUSE_DEPTH);
+    if (!match) return false;
+    
+    // The matching node becomes the root where it is; the branches left
+    // behind stay in the arenas until the tree is released
+    if (!match->game_state) {
+        match->game_state = storeState(*tree.arenas[0], game);
+    }
+    tree.root = match;
+    while (static_cast<int>(tree.arenas.size()) < num_workers) {
+        tree.arenas.push_back(std::make_unique<TreeArena>());
+    }
+    return true;
+}
+
+template <typename GameT>
+typename BasicMCTS<GameT>::Node* BasicMCTS<GameT>::findPosition(Node* node, GameT& state,
+                                                                const GameT& target, int depth) {
+    if (samePosition(state, target)) return node;
+    if (depth == 0) return nullptr;
+    
+    int num_children = node->num_children.load(std::memory_order_acquire);
+    for (int i = 0; i < num_children; ++i) {
+        Node* child = &node->children[i];
+        state.makeMove(child->parent_action);
+        Node* match = findPosition(child->resolve(), state, target, depth - 1);
+        state.unmakeMove(child->parent_action);
+        if (match) return match;
+    }
+    return nullptr;
+}
+
+template <typename GameT>
+void BasicMCTS<GameT>::runSimulation(Node* root, WorkerContext& worker) {
+    GameT* state = worker.state.get();
+    worker.moves.clear();
+    if (!root || (!state && !root->game_state)) return;
+    
+    SearchCounters& counters = *worker.counters;
+    PhaseTimer timer;
+    auto node = descend(root, worker, timer);
+    int rollouts = std::max(1, config_.rollouts_per_node);
+    int reward = playouts(node, worker, rollouts);
+    timer.lap(counters.simulate_ns);
+    
+    backpropagate(worker.path, reward, rollouts);
+    if (config_.use_solver) {
+        solve(worker.path, state ? *state : *node->game_state);
+    }
+    restoreRoot(state, worker.moves);
+    timer.lap(counters.backpropagate_ns);
+    
+    simulations_.fetch_add(1, std::memory_order_relaxed);
+    ++counters.simulations;
+    counters.playouts += rollouts;
+    counters.addDepth(static_cast<int>(worker.path.size()) - 1);
+}
+
+template <typename GameT>
+uint64_t BasicMCTS<GameT>::taskSeed(uint64_t task) const {
+    // Mixes the seed, the search and the task
+    return mix64(mix64(base_seed_ ^ (searches_ * 0x9e3779b97f4a7c15ULL)) ^ (task * 0xd1b54a32d192ed03ULL));
+}
+
+template <typename GameT>
+int BasicMCTS<GameT>::claimSimulations(int count) {
+    if (config_.num_simulations <= 0) return count;
+    int start = claimed_.fetch_add(count, std::memory_order_relaxed);
+    return std::max(0, std::min(count, config_.num_simulations - start));
+}
+
+template <typename GameT>
+bool BasicMCTS<GameT>::outOfBudget(const Tree& tree) const {
+    if (stop_requested_.load(std::memory_order_relaxed)) return true;
+    if (tree.root->proof.load(std::memory_order_relaxed) != 0) return true;
+    if (tree.max_nodes > 0 && tree.num_nodes.load(std::memory_order_relaxed) >= tree.max_nodes) {
+        return true;
+    }
+    return config_.time_limit_ms > 0 && std::chrono::steady_clock::now() >= deadline_;
+}
+
+template <typename GameT>
+typename BasicMCTS<GameT>::WorkerContext BasicMCTS<GameT>::makeWorker(const GameT& root_state,
+                                                                      Xoshiro256& rng,
+                                                                      Tree& tree,
+                                                                      int worker_index,
+                                                                      SearchCounters& counters) const {
+    WorkerContext worker;
+    if (config_.use_unmake) {
+        worker.state = copyState(root_state);
+    }
+    worker.rng = &rng;
+    worker.tree = &tree;
+    worker.arena = tree.arenas[worker_index].get();
+    worker.counters = &counters;
+    return worker;
+}
+
+template <typename GameT>
+typename BasicMCTS<GameT>::Node* BasicMCTS<GameT>::descend(Node* root, WorkerContext& worker, PhaseTimer& timer) {
+    worker.path.clear();
+    worker.path.push_back(root);
+    addVirtualLoss(root);
+    auto node = select(root, worker);
+    timer.lap(worker.counters->select_ns);
+    node = expand(node, worker);
+    timer.lap(worker.counters->expand_ns);
+    return node;
+}
+
+template <typename GameT>
+void BasicMCTS<GameT>::restoreRoot(GameT* state, const std::vector<int>& moves) const {
+    // Walk the shared state back to the root position
+    if (state) {
+        for (auto it = moves.rbegin(); it != moves.rend(); ++it) {
+            state->unmakeMove(*it);
+        }
+    }
+}
+
+template <typename GameT>
+typename BasicMCTS<GameT>::Node* BasicMCTS<GameT>::select(Node* node, WorkerContext& worker) {
+    GameT* state = worker.state.get();
+    if (!node || (!state && !node->game_state)) return nullptr;
 
     // If there are untried actions, return this node
-    if (!node->untried_actions.empty()) {
+    if (node->numUntried() > 0) {
         return node;
     }
 
     // If no children, return this node
-    if (node->children.empty()) {
+    int num_children = node->num_children.load(std::memory_order_acquire);
+    if (num_children == 0) {
         return node;
     }
 
-    // Select best child using UCB1
-    MCTSNode* best_child = nullptr;
+    // Select best child using UCB1. Pending virtual losses count as visits
+    // that lost, steering concurrent threads towards different children.
+    Node* best_child = nullptr;
     double best_value = -1e9;
+    bool descend = true;
     
-    std::lock_guard<std::mutex> lock(node->mutex);
-    double parent_visits = node->stats[0];
-    if (parent_visits == 0) return node->children[0].get();
-
-    for (const auto& child : node->children) {
-        if (!child) continue;
-        
-        std::lock_guard<std::mutex> child_lock(child->mutex);
-        if (child->stats[0] == 0) {
-            return child.get();
-        }
+    double parent_visits = node->stats.visits.load(std::memory_order_relaxed) +
+                           node->stats.virtual_loss.load(std::memory_order_relaxed);
+    if (parent_visits == 0) {
+        best_child = &node->children[0];
+        descend = false;
+    } else {
+        for (int i = 0; i < num_children; ++i) {
+            Node* child = &node->children[i];
+            // The outcome of proven children is known; search the others
+            if (config_.use_solver && child->resolve()->proof.load(std::memory_order_relaxed) != 0) {
+                continue;
+            }
+            
+            const MCTSNodeStats& stats = child->resolve()->stats;
+            int pending = stats.virtual_loss.load(std::memory_order_relaxed);
+            double visits = stats.visits.load(std::memory_order_relaxed) + pending;
+            if (visits == 0) {
+                best_child = child;
+                descend = false;
+                break;
+            }
 
-        double exploitation = child->stats[1] / child->stats[0];
-        double exploration = config_.exploration_constant * 
-                            std::sqrt(std::log(parent_visits) / child->stats[0]);
-        double ucb1 = exploitation + exploration;
+            double wins = static_cast<double>(stats.wins.load(std::memory_order_relaxed)) - pending;
+            double exploitation = wins / visits;
+            double exploration = config_.exploration_constant * 
+                                std::sqrt(std::log(parent_visits) / visits);
+            double ucb1 = exploitation + exploration;
 
-        if (ucb1 > best_value) {
-            best_value = ucb1;
-            best_child = child.get();
+            if (ucb1 > best_value) {
+                best_value = ucb1;
+                best_child = child;
+            }
         }
     }
 
+    if (!best_child) return node;
+    Node* next = best_child->resolve();
+    addVirtualLoss(next);
+    worker.path.push_back(next);
+    if (state) {
+        state->makeMove(best_child->parent_action);
+        worker.moves.push_back(best_child->parent_action);
+    }
+
     // Recursively select from best child
-    return best_child ? select(best_child) : node;
+    return descend ? select(next, worker) : next;
 }
 
-MCTSNode* MCTS::expand(MCTSNode* node) {
-    if (!node || !node->game_state || node->untried_actions.empty() || node->game_state->isGameOver()) {
+template <typename GameT>
+typename BasicMCTS<GameT>::Node* BasicMCTS<GameT>::expand(Node* node, WorkerContext& worker) {
+    GameT* state = worker.state.get();
+    GameT* node_state = state ? state : (node ? node->game_state : nullptr);
+    if (!node || !node_state || node->numUntried() <= 0 || node_state->isGameOver()) {
         return node;
     }
     
-    std::lock_guard<std::mutex> lock(node->mutex);
+    ExpansionGuard guard(node->expanding, worker.counters->lock_wait_ns);
+    int slot = node->num_children.load(std::memory_order_relaxed);
+    if (slot >= node->num_actions) return node;
     
-    // Get valid actions
-    auto valid_actions = node->game_state->getPossibleActions();
-    if (valid_actions.empty()) return node;
-    
-    // Find a valid action from untried actions
-    int action = -1;
-    while (!node->untried_actions.empty()) {
-        action = node->untried_actions.back();
-        if (std::find(valid_actions.begin(), valid_actions.end(), action) != valid_actions.end()) {
-            node->untried_actions.pop_back();
-            break;
-        }
-        node->untried_actions.pop_back();
-    }
+    // Children take the node's actions in reverse generation order
+    ActionList valid_actions;
+    node_state->generateActions(valid_actions);
+    if (valid_actions.size() != node->num_actions) return node;
+    int action = valid_actions[valid_actions.size() - 1 - slot];
     
-    if (action == -1) return node;
+    // The first expansion reserves the slots of all children at once
+    if (!node->children) {
+        node->children = createChildren(*worker.tree, *worker.arena, node);
+    }
     
-    auto child_state = node->game_state->clone();
-    if (!child_state) return node;
+    Node* child = &node->children[slot];
+    GameT* child_state = state;
+    if (state) {
+        // Advance the shared state; the child only records the move
+        state->makeMove(action);
+        worker.moves.push_back(action);
+    } else {
+        child_state = storeState(*worker.arena, *node->game_state);
+        
+        try {
+            child_state->makeMove(action);
+        } catch (const std::exception&) {
+            return node;
+        }
+        
+        child->game_state = child_state;
+    }
+    child->parent_action = action;
     
-    try {
-        child_state->makeMove(action);
-    } catch (const std::exception&) {
-        return node;
+    // Link to the node of the same position if another path reached it
+    TranspositionTable<Node>* table = worker.tree->table.get();
+    Node* target = child;
+    if (table) {
+        uint64_t hash = child_state->getHash();
+        child->transposition = table->find(hash);
+        if (child->transposition) {
+            target = child->transposition;
+        } else {
+            child->hash = hash;
+        }
+    }
+    if (target == child) {
+        child->num_actions = countActions(*child_state);
+        if (table) table->insert(child);
     }
     
-    auto child = new MCTSNode(std::move(child_state), action, node);
-    if (!child) return node;
+    // Publish the filled slot to lock-free readers
+    node->num_children.store(slot + 1, std::memory_order_release);
     
-    node->children.push_back(std::unique_ptr<MCTSNode>(child));
-    return child;
+    addVirtualLoss(target);
+    worker.path.push_back(target);
+    return target;
 }
 
-int MCTS::simulate(MCTSNode* node) {
-    if (!node || !node->game_state) return 0;
+template <typename GameT>
+int BasicMCTS<GameT>::playouts(Node* node, WorkerContext& worker, int count) {
+    GameT* state = worker.state.get();
+    if (!state || std::is_same<GameT, ConnectFour>::value) {
+        return simulate(state ? *state : *node->game_state, count, *worker.rng);
+    }
     
-    auto simulation = node->game_state->clone();
-    if (!simulation) return 0;
+    // Play on the shared state, walking back to the leaf after each rollout
+    size_t leaf_depth = worker.moves.size();
+    int total = 0;
+    for (int i = 0; i < count; ++i) {
+        total += rollout(state, &worker.moves, *worker.rng);
+        while (worker.moves.size() > leaf_depth) {
+            state->unmakeMove(worker.moves.back());
+            worker.moves.pop_back();
+        }
+    }
+    return total;
+}
+
+template <typename GameT>
+int BasicMCTS<GameT>::simulate(const GameT& state, int count, Xoshiro256& rng) {
+    if constexpr (std::is_same<GameT, ConnectFour>::value) {
+        // Uniform rollouts, so move ordering would not change the outcome
+        return ConnectFourRollouts::play(state, count, rng);
+    }
     
-    while (!simulation->isGameOver()) {
-        auto actions = simulation->getPossibleActions();
+    int total = 0;
+    for (int i = 0; i < count; ++i) {
+        // Concrete states are copied onto the stack
+        if constexpr (std::is_abstract<GameT>::value) {
+            auto simulation = state.clone();
+            if (!simulation) continue;
+            total += rollout(simulation.get(), nullptr, rng);
+        } else {
+            GameT simulation = state;
+            total += rollout(&simulation, nullptr, rng);
+        }
+    }
+    return total;
+}
+
+template <typename GameT>
+int BasicMCTS<GameT>::rollout(GameT* state, std::vector<int>* moves, Xoshiro256& rng) {
+    int player = state->getCurrentPlayer();
+    ActionList actions;
+    while (!state->isGameOver()) {
+        state->generateActions(actions);
         if (actions.empty()) break;
         
         if (config_.use_move_ordering) {
-            orderActions(actions, simulation.get());
+            orderActions(actions, state);
         }
         
         // Try to make a valid move
         bool move_made = false;
-        for (int attempts = 0; attempts < actions.size() && !move_made; ++attempts) {
-            int action = actions[rand() % actions.size()];
+        while (!actions.empty() && !move_made) {
+            int index = rng.below(actions.size());
             try {
-                simulation->makeMove(action);
+                state->makeMove(actions[index]);
+                if (moves) moves->push_back(actions[index]);
                 move_made = true;
             } catch (const std::exception&) {
                 // Remove invalid action and try another
-                actions.erase(std::remove(actions.begin(), actions.end(), action), actions.end());
+                actions.swapRemove(index);
             }
         }
         
@@ -206,98 +668,326 @@ int MCTS::simulate(MCTSNode* node) {
     }
     
     if (config_.use_heuristic) {
-        return evaluateState(simulation.get());
+        return evaluateState(state, player);
+    }
+    
+    return state->getReward(player);
+}
+
+template <typename GameT>
+void BasicMCTS<GameT>::backpropagate(const std::vector<Node*>& path, int reward, int visits) {
+    // The player who moved into the last node is the other side, and the
+    // point of view flips with every ply up
+    int node_reward = -reward;
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        Node* node = *it;
+        node->stats.visits.fetch_add(visits, std::memory_order_relaxed);
+        node->stats.wins.fetch_add(node_reward, std::memory_order_relaxed);
+        node->stats.virtual_loss.fetch_sub(config_.virtual_loss, std::memory_order_relaxed);
+        node_reward = -node_reward;
+    }
+}
+
+template <typename GameT>
+void BasicMCTS<GameT>::solve(const std::vector<Node*>& path, const GameT& leaf_state) const {
+    Node* leaf = path.back();
+    if (leaf->proof.load(std::memory_order_acquire) == 0) {
+        int proof = 0;
+        if (leaf_state.isGameOver()) {
+            // The reward of the side to move is the opposite of the result
+            // for the player who moved into the leaf
+            int reward = leaf_state.getReward(leaf_state.getCurrentPlayer());
+            proof = MCTSProof::encode(reward < 0 ? MCTSProof::Win :
+                                      reward > 0 ? MCTSProof::Loss : MCTSProof::Draw, 0);
+        } else {
+            // Another parent's simulations may have proven all the children
+            proof = computeProof(leaf);
+        }
+        if (proof == 0) return;
+        leaf->proof.store(proof, std::memory_order_release);
     }
     
-    return simulation->getReward(simulation->getCurrentPlayer());
+    for (size_t i = path.size() - 1; i-- > 0;) {
+        Node* node = path[i];
+        if (node->proof.load(std::memory_order_acquire) != 0) continue;
+        int proof = computeProof(node);
+        if (proof == 0) return;
+        node->proof.store(proof, std::memory_order_release);
+    }
 }
 
-void MCTS::backpropagate(MCTSNode* node, int reward) {
-    while (node != nullptr) {
-        std::lock_guard<std::mutex> lock(node->mutex);
-        node->stats[0] += 1; // Increment visits
-        node->stats[1] += reward; // Add reward
-        node = node->parent;
+template <typename GameT>
+int BasicMCTS<GameT>::computeProof(const Node* node) {
+    int num_children = node->num_children.load(std::memory_order_acquire);
+    bool complete = num_children > 0 && num_children == node->num_actions;
+    int win_distance = -1;
+    int loss_distance = 0;
+    int draw_distance = -1;
+    
+    for (int i = 0; i < num_children; ++i) {
+        int proof = node->children[i].resolve()->proof.load(std::memory_order_acquire);
+        int distance = MCTSProof::distance(proof) + 1;
+        switch (MCTSProof::result(proof)) {
+            case MCTSProof::Win:
+                if (win_distance < 0 || distance < win_distance) win_distance = distance;
+                break;
+            case MCTSProof::Loss:
+                loss_distance = std::max(loss_distance, distance);
+                break;
+            case MCTSProof::Draw:
+                draw_distance = std::max(draw_distance, distance);
+                break;
+            case MCTSProof::Unknown:
+                complete = false;
+                break;
+        }
     }
+    
+    // The side to move here picks the child: one winning child is enough
+    // and loses the node for the player who moved into it
+    if (win_distance >= 0) return MCTSProof::encode(MCTSProof::Loss, win_distance);
+    if (!complete) return 0;
+    if (draw_distance >= 0) return MCTSProof::encode(MCTSProof::Draw, draw_distance);
+    return MCTSProof::encode(MCTSProof::Win, loss_distance);
+}
+
+template <typename GameT>
+void BasicMCTS<GameT>::addVirtualLoss(Node* node) const {
+    node->stats.virtual_loss.fetch_add(config_.virtual_loss, std::memory_order_relaxed);
 }
 
-void MCTS::parallelSimulate(MCTSNode* root, int num_threads) {
-    if (!root) return;
+template <typename GameT>
+ThreadPool& BasicMCTS<GameT>::getPool() {
+    if (config_.thread_pool) {
+        return *config_.thread_pool;
+    }
+    if (!pool_ || pool_->size() != config_.num_threads) {
+        pool_ = std::make_shared<ThreadPool>(config_.num_threads, config_.seed);
+    }
+    return *pool_;
+}
+
+template <typename GameT>
+void BasicMCTS<GameT>::parallelSimulate(Tree& tree) {
+    Node* root = tree.root;
+    if (!root || !root->game_state) return;
+    
+    ThreadPool& pool = getPool();
+    counters_.assign(pool.size(), SearchCounters());
+    std::vector<WorkerContext> workers;
+    for (int i = 0; i < pool.size(); ++i) {
+        workers.push_back(makeWorker(*root->game_state, pool.rng(i), tree, i, counters_[i]));
+    }
     
-    std::vector<std::thread> threads;
-    int simulations_per_thread = std::max(1, config_.num_simulations / num_threads);
+    // Every worker claims small batches from the shared budget until it runs
+    // out, so faster workers simply end up running more simulations
+    std::vector<ThreadPool::Task> tasks;
+    for (int i = 0; i < pool.size(); ++i) {
+        tasks.push_back([this, root, &tree, &workers](int worker) {
+            int count;
+            while (!outOfBudget(tree) && (count = claimSimulations(SIMULATIONS_PER_TASK)) > 0) {
+                for (int s = 0; s < count && !outOfBudget(tree); ++s) {
+                    runSimulation(root, workers[worker]);
+                }
+            }
+        });
+    }
+    pool.run(tasks, &stop_requested_);
+}
+
+template <typename GameT>
+size_t BasicMCTS<GameT>::rootParallelSimulate(const GameT& game, std::vector<ActionStats>& totals) {
+    ThreadPool& pool = getPool();
+    counters_.assign(pool.size(), SearchCounters());
+    // Deterministic search splits the simulations into one fixed share per
+    // thread; otherwise every worker grows a tree from the shared budget
+    bool deterministic = config_.deterministic && config_.num_simulations > 0;
+    int num_trees = deterministic ? config_.num_threads : pool.size();
+    size_t nodes_per_tree = config_.max_nodes > 0 ? std::max<size_t>(1, config_.max_nodes / num_trees) : 0;
+    std::vector<std::vector<ActionStats>> tree_stats(num_trees);
+    std::vector<size_t> tree_nodes(num_trees);
     
-    for (int i = 0; i < num_threads; ++i) {
-        threads.emplace_back(&MCTS::workerThread, this, root, simulations_per_thread);
+    std::vector<ThreadPool::Task> tasks;
+    for (int i = 0; i < num_trees; ++i) {
+        tasks.push_back([this, &game, &tree_stats, &tree_nodes, &pool, i, num_trees, nodes_per_tree,
+                         deterministic](int worker) {
+            // Private tree per task; nothing is shared until the merge
+            Tree tree;
+            initTree(tree, game, 1, nodes_per_tree);
+            Xoshiro256 task_rng(taskSeed(i + 1));
+            auto context = makeWorker(game, deterministic ? task_rng : pool.rng(worker), tree, 0,
+                                      counters_[worker]);
+            
+            if (deterministic) {
+                long long total = config_.num_simulations;
+                long long share = total * (i + 1) / num_trees - total * i / num_trees;
+                for (long long s = 0; s < share && !outOfBudget(tree); ++s) {
+                    runSimulation(tree.root, context);
+                }
+            } else {
+                int count;
+                while (!outOfBudget(tree) && (count = claimSimulations(SIMULATIONS_PER_TASK)) > 0) {
+                    for (int s = 0; s < count && !outOfBudget(tree); ++s) {
+                        runSimulation(tree.root, context);
+                    }
+                }
+            }
+            accumulateRootStats(tree.root, tree_stats[i]);
+            tree_nodes[i] = tree.num_nodes.load(std::memory_order_relaxed);
+        });
     }
+    pool.run(tasks, &stop_requested_);
     
-    for (auto& thread : threads) {
-        if (thread.joinable()) {
-            thread.join();
+    for (const auto& stats : tree_stats) {
+        for (const auto& entry : stats) {
+            auto it = std::find_if(totals.begin(), totals.end(),
+                                   [&](const ActionStats& total) { return total.action == entry.action; });
+            if (it == totals.end()) {
+                totals.push_back(entry);
+            } else {
+                it->visits += entry.visits;
+                it->wins += entry.wins;
+                if (it->proof == 0) it->proof = entry.proof;
+            }
         }
     }
+    
+    size_t nodes = 0;
+    for (size_t count : tree_nodes) nodes += count;
+    return nodes;
 }
 
-void MCTS::workerThread(MCTSNode* root, int num_simulations) {
-    if (!root) return;
+template <typename GameT>
+void BasicMCTS<GameT>::leafParallelSimulate(Tree& tree) {
+    Node* root = tree.root;
+    if (!root || !root->game_state) return;
+    
+    ThreadPool& pool = getPool();
+    bool deterministic = config_.deterministic;
+    int num_rollouts = deterministic ? config_.num_threads : pool.size();
+    int rollouts = std::max(1, config_.rollouts_per_node);
+    uint64_t next_task = 1;
+    // Pool workers count their rollouts; the calling thread comes last
+    counters_.assign(pool.size() + 1, SearchCounters());
+    SearchCounters& counters = counters_.back();
+    auto context = makeWorker(*root->game_state, rng_, tree, 0, counters);
+    std::vector<int> rewards(num_rollouts);
     
-    for (int i = 0; i < num_simulations; ++i) {
-        auto node = select(root);
-        if (!node) continue;
+    std::vector<ThreadPool::Task> tasks;
+    int count;
+    while (!outOfBudget(tree) && (count = claimSimulations(num_rollouts)) > 0) {
+        // Selection and expansion stay on this thread; only rollouts fan out
+        context.moves.clear();
+        PhaseTimer timer;
+        Node* leaf = descend(root, context, timer);
+        const GameT& leaf_state = context.state ? *context.state : *leaf->game_state;
         
-        node = expand(node);
-        if (!node) continue;
+        tasks.clear();
+        for (int t = 0; t < count; ++t) {
+            uint64_t seed = taskSeed(next_task++);
+            tasks.push_back([this, &leaf_state, &rewards, &pool, t, rollouts, deterministic,
+                             seed](int worker) {
+                PhaseTimer task_timer;
+                if (deterministic) {
+                    Xoshiro256 task_rng(seed);
+                    rewards[t] = simulate(leaf_state, rollouts, task_rng);
+                } else {
+                    rewards[t] = simulate(leaf_state, rollouts, pool.rng(worker));
+                }
+                task_timer.lap(counters_[worker].simulate_ns);
+                counters_[worker].playouts += rollouts;
+            });
+        }
+        pool.run(tasks, &stop_requested_);
+        // The wait for the rollouts is already counted by the workers
+        long long waited_ns = 0;
+        timer.lap(waited_ns);
+        
+        int total_reward = 0;
+        for (int t = 0; t < count; ++t) total_reward += rewards[t];
+        backpropagate(context.path, total_reward, count * rollouts);
+        if (config_.use_solver) {
+            solve(context.path, leaf_state);
+        }
+        restoreRoot(context.state.get(), context.moves);
+        timer.lap(counters.backpropagate_ns);
+        
+        simulations_.fetch_add(count, std::memory_order_relaxed);
+        counters.simulations += count;
+        counters.addDepth(static_cast<int>(context.path.size()) - 1, count);
+    }
+}
+
+template <typename GameT>
+void BasicMCTS<GameT>::accumulateRootStats(const Node* root, std::vector<ActionStats>& totals) {
+    int num_children = root->num_children.load();
+    for (int i = 0; i < num_children; ++i) {
+        const Node* child = &root->children[i];
+        const MCTSNodeStats& stats = child->resolve()->stats;
+        totals.push_back({child->parent_action, stats.visits.load(), stats.wins.load(),
+                          child->resolve()->proof.load()});
+    }
+}
+
+template <typename GameT>
+void BasicMCTS<GameT>::collectStats(std::chrono::steady_clock::time_point start) {
+    auto to_ms = [](long long ns) { return ns / 1e6; };
+    long long depth_sum = 0;
+    
+    for (const auto& counters : counters_) {
+        stats_.simulations += counters.simulations;
+        stats_.playouts += counters.playouts;
+        stats_.max_depth = std::max(stats_.max_depth, counters.max_depth);
+        stats_.select_ms += to_ms(counters.select_ns);
+        stats_.expand_ms += to_ms(counters.expand_ns);
+        stats_.simulate_ms += to_ms(counters.simulate_ns);
+        stats_.backpropagate_ms += to_ms(counters.backpropagate_ns);
+        stats_.lock_wait_ms += to_ms(counters.lock_wait_ns);
+        depth_sum += counters.depth_sum;
         
-        int reward = simulate(node);
-        backpropagate(node, reward);
+        SearchStats::Thread thread;
+        thread.simulations = counters.simulations;
+        thread.playouts = counters.playouts;
+        thread.busy_ms = to_ms(counters.select_ns + counters.expand_ns + counters.simulate_ns +
+                               counters.backpropagate_ns);
+        stats_.threads.push_back(thread);
     }
+    stats_.avg_depth = stats_.simulations > 0 ? static_cast<double>(depth_sum) / stats_.simulations : 0;
+    stats_.total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
 }
 
-double MCTS::evaluateState(const Game* state) const {
+template <typename GameT>
+double BasicMCTS<GameT>::evaluateState(const GameT* state, int player) const {
     if (!state) return 0.0;
-    return state->getReward(state->getCurrentPlayer());
+    return state->getReward(player);
 }
 
-void MCTS::orderActions(std::vector<int>& actions, const Game* state) const {
+template <typename GameT>
+void BasicMCTS<GameT>::orderActions(ActionList& actions, GameT* state) const {
     if (!state) return;
     
-    // First, find winning moves
-    std::vector<int> winning_moves;
-    std::vector<int> blocking_moves;
-    std::vector<int> other_moves;
+    // Winning moves first, then moves that block an opponent win, then the rest
+    ActionList winning_moves;
+    ActionList blocking_moves;
+    state->generateTacticalMoves(winning_moves, blocking_moves);
+    if (winning_moves.empty() && blocking_moves.empty()) return;
     
+    ActionList other_moves;
     for (int action : actions) {
-        if (state->isWinningMove(action)) {
-            winning_moves.push_back(action);
-        } else {
-            // Check if this move blocks opponent's winning move
-            auto clone = state->clone();
-            if (!clone) continue;
-            
-            try {
-                clone->makeMove(action);
-                bool blocks = false;
-                for (int opponent_move : clone->getPossibleActions()) {
-                    if (clone->isWinningMove(opponent_move)) {
-                        blocks = true;
-                        break;
-                    }
-                }
-                
-                if (blocks) {
-                    blocking_moves.push_back(action);
-                } else {
-                    other_moves.push_back(action);
-                }
-            } catch (const std::exception&) {
-                other_moves.push_back(action);
-            }
+        if (!winning_moves.contains(action) && !blocking_moves.contains(action)) {
+            other_moves.push_back(action);
         }
     }
     
     // Combine moves in priority order
     actions.clear();
-    actions.insert(actions.end(), winning_moves.begin(), winning_moves.end());
-    actions.insert(actions.end(), blocking_moves.begin(), blocking_moves.end());
-    actions.insert(actions.end(), other_moves.begin(), other_moves.end());
-} 
\ No newline at end of file
+    for (int action : winning_moves) actions.push_back(action);
+    for (int action : blocking_moves) {
+        if (!winning_moves.contains(action)) actions.push_back(action);
+    }
+    for (int action : other_moves) actions.push_back(action);
+}
+
+template class BasicMCTS<Game>;
+template class BasicMCTS<ConnectFour>;
+template class BasicMCTS<TicTacToe>;
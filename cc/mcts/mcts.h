@@ -1,63 +1,331 @@
 #pragma once
 #include "../games/game.h"
+#include "arena.h"
+#include "search_stats.h"
+#include "thread_pool.h"
+#include "transposition_table.h"
 #include <memory>
 #include <vector>
 #include <thread>
-#include <mutex>
-
-struct MCTSNode {
-    std::vector<double> stats; // [visits, wins, UCB1 value]
-    std::vector<int> untried_actions;
-    std::vector<std::unique_ptr<MCTSNode>> children;
-    std::unique_ptr<Game> game_state;
-    int parent_action;
-    MCTSNode* parent;
-    std::mutex mutex; // For thread safety
-
-    MCTSNode(std::unique_ptr<Game> state, int action = -1, MCTSNode* p = nullptr)
-        : stats(3, 0.0), game_state(std::move(state)), parent_action(action), parent(p) {
-        untried_actions = game_state->getPossibleActions();
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+
+class ConnectFourSolver;
+class OpeningBook;
+
+// Visit statistics of a node, updated lock-free by the search threads
+struct MCTSNodeStats {
+    std::atomic<int> visits{0};
+    std::atomic<long long> wins{0};       // Sum of backpropagated rewards
+    std::atomic<int> virtual_loss{0};     // Pending losses of in-flight simulations
+};
+
+// Game-theoretic value of a node proven by the solver, packed into one int:
+// the result for the player who moved into the node, and the plies left
+// until the game ends with best play. 0 means unproven.
+struct MCTSProof {
+    enum Result { Unknown, Win, Loss, Draw };
+
+    static int encode(Result result, int distance) { return distance << 2 | result; }
+    static Result result(int proof) { return static_cast<Result>(proof & 3); }
+    static int distance(int proof) { return proof >> 2; }
+};
+
+/**
+ * Search tree node. Nodes live in the arenas of their tree and are released
+ * with it, so a node owns nothing: its children are a contiguous range of
+ * num_actions slots reserved on the first expansion, and its state (clone
+ * mode only) is held by the tree's state arena.
+ *
+ * Statistics and proofs are from the point of view of the player who moved
+ * into the node; the search assumes the two players alternate.
+ *
+ * With transpositions enabled the tree is a DAG: a child slot whose
+ * position already has a node links to it, and that node then has several
+ * parents. Nodes therefore keep no parent pointer; simulations record
+ * their path instead.
+ */
+template <typename GameT>
+struct BasicMCTSNode {
+    MCTSNodeStats stats;
+    std::atomic<int> proof{0};         // MCTSProof encoding (use_solver only)
+    std::atomic<int> num_children{0};  // Published children slots, filled in order
+    std::atomic<bool> expanding{false}; // Serializes expansion
+    int num_actions = 0;               // Legal actions, one child slot each
+    int parent_action = -1;            // Move leading to this slot from the parent
+    uint64_t hash = 0;                 // Position key (transpositions only)
+    BasicMCTSNode* transposition = nullptr;  // Node this slot links to, if any
+    BasicMCTSNode* children = nullptr;
+    GameT* game_state = nullptr;       // Null when the search replays moves with makeMove/unmakeMove
+
+    // The node holding this slot's statistics and children
+    BasicMCTSNode* resolve() { return transposition ? transposition : this; }
+    const BasicMCTSNode* resolve() const { return transposition ? transposition : this; }
+
+    int numUntried() const {
+        return num_actions - num_children.load(std::memory_order_acquire);
     }
 };
 
-class MCTS {
-public:
-    struct Config {
-        double exploration_constant;
-        int num_simulations;
-        int num_threads;
-        bool use_heuristic;
-        bool use_move_ordering;
-
-        Config() : 
-            exploration_constant(1.41),
-            num_simulations(1000),
-            num_threads(std::thread::hardware_concurrency()),
-            use_heuristic(false),
-            use_move_ordering(false) {}
+using MCTSNode = BasicMCTSNode<Game>;
+static_assert(std::is_trivially_destructible<MCTSNode>::value,
+              "Nodes are released with their arena without running destructors");
+
+struct MCTSConfig {
+    // How worker threads share the search when num_threads > 1
+    enum class SearchMode {
+        Tree,  // All threads grow one shared tree
+        Root,  // Each thread grows a private tree; root children are merged at the end
+        Leaf   // One tree; every expanded leaf gets num_threads parallel rollouts
     };
 
-    explicit MCTS(const Config& config = Config());
-    
-    int selectAction(Game* game);
-    void setConfig(const Config& config) { config_ = config; }
-    const Config& getConfig() const { return config_; }
+    double exploration_constant;
+    int num_simulations;   // Simulations per move; 0 leaves the limit to the budgets below or stop()
+    double time_limit_ms;  // Wall-clock budget per move (0 = none)
+    size_t max_nodes;      // Node slots a search tree may allocate, bounding its memory (0 = none)
+    int rollouts_per_node; // Rollouts per simulation, backpropagated together
+    // Seed of the search's generators (0 = from std::random_device, or a
+    // fixed seed in deterministic mode)
+    uint64_t seed;
+    // Same seed and num_threads give the same statistics and move. Shared-tree
+    // search then runs like root mode, with fixed shares of num_simulations;
+    // time limits and stop() still depend on timing, and so does the split
+    // of the work between threads.
+    bool deterministic;
+    int num_threads;
+    bool use_heuristic;
+    bool use_move_ordering;
+    bool use_unmake;  // Walk one state per worker with make/unmake instead of cloning per node
+    // Keep the tree and continue from the played position on the next call.
+    // Branches that were not played are released with the tree, once a
+    // position is not found or max_nodes is reached. Root parallel search
+    // (Root mode, or deterministic Tree mode on several threads) always
+    // starts fresh trees.
+    bool reuse_tree;
+    // Prove wins, losses and draws from terminal positions up. Proven
+    // children are no longer searched, a proven root ends the search, and
+    // proven wins are played over any average.
+    bool use_solver;
+    bool use_transpositions;          // Share one node between move orders reaching the same position
+    size_t transposition_table_size;  // Entries of the transposition table of each tree
+    int virtual_loss; // Losses charged to each node on a simulation's path until it is backpropagated
+    SearchMode search_mode;
+    std::shared_ptr<ThreadPool> thread_pool;  // Worker pool to search with; created on demand when null
+    std::shared_ptr<const OpeningBook> opening_book;  // Connect Four positions played without searching
+    // Connect Four positions with fewer empty cells are played from an
+    // alpha-beta solve instead of searched; past time_limit_ms the solve
+    // plays its deepest completed iteration (0 = never)
+    int exact_solver_threshold;
+    // Play games' perfect-play tables (Game::lookupPerfectPlay) instead of searching
+    bool use_perfect_play;
+
+    MCTSConfig() :
+        exploration_constant(1.41),
+        num_simulations(1000),
+        time_limit_ms(0),
+        max_nodes(0),
+        rollouts_per_node(1),
+        seed(0),
+        deterministic(false),
+        num_threads(std::thread::hardware_concurrency()),
+        use_heuristic(false),
+        use_move_ordering(false),
+        use_unmake(false),
+        reuse_tree(false),
+        use_solver(false),
+        use_transpositions(false),
+        transposition_table_size(1 << 16),
+        virtual_loss(1),
+        search_mode(SearchMode::Tree),
+        exact_solver_threshold(0),
+        use_perfect_play(false) {}
+};
+
+/**
+ * Interface shared by all MCTS instantiations, so callers such as
+ * GameManager can hold a search specialized for the game they created.
+ */
+class MCTSEngine {
+public:
+    virtual ~MCTSEngine() = default;
+
+    virtual int selectAction(Game* game) = 0;
+    virtual void setConfig(const MCTSConfig& config) = 0;
+    virtual const MCTSConfig& getConfig() const = 0;
+
+    // Ends a running selectAction early, which then returns the best action
+    // found so far. Safe to call from any thread.
+    virtual void stop() = 0;
+    // Simulations completed by the current or last selectAction
+    virtual int getSimulationCount() const = 0;
+    // Statistics of the last completed selectAction
+    virtual const SearchStats& getSearchStats() const = 0;
+};
+
+/**
+ * Monte Carlo Tree Search over game type GameT.
+ *
+ * With a concrete final game class (ConnectFour, TicTacToe) every game call
+ * in the search loop is resolved statically and can be inlined; those games
+ * define their move generation, move making and win detection in their
+ * headers for this reason. MCTS, the
+ * instantiation over the abstract Game, goes through virtual dispatch and
+ * works with any Game implementation.
+ *
+ * Instantiations for Game, ConnectFour and TicTacToe are provided by mcts.cc.
+ */
+template <typename GameT>
+class BasicMCTS : public MCTSEngine {
+public:
+    using Config = MCTSConfig;
+    using Node = BasicMCTSNode<GameT>;
+
+    explicit BasicMCTS(const Config& config = Config());
+    ~BasicMCTS() override;
+
+    // Returns -1 if game is null, finished or not a GameT
+    int selectAction(Game* game) override;
+    void setConfig(const Config& config) override;
+    const Config& getConfig() const override { return config_; }
+    void stop() override { stop_requested_.store(true, std::memory_order_relaxed); }
+    int getSimulationCount() const override { return simulations_.load(std::memory_order_relaxed); }
+    const SearchStats& getSearchStats() const override { return stats_; }
 
 private:
+    // Accumulated statistics of one root action
+    struct ActionStats {
+        int action;
+        long long visits;
+        long long wins;
+        int proof;
+    };
+
+    // Node states are stored by value, or behind a pointer for abstract games
+    using StateHolder = std::conditional_t<std::is_abstract<GameT>::value,
+                                           std::unique_ptr<GameT>, GameT>;
+
+    // Storage one worker expands the tree into
+    struct TreeArena {
+        Arena<Node> nodes;
+        Arena<StateHolder> states;
+    };
+
+    // A search tree with one arena per worker, so expansions never contend
+    // for memory. Destroying the tree releases all nodes at once.
+    struct Tree {
+        Node* root = nullptr;
+        std::vector<std::unique_ptr<TreeArena>> arenas;
+        std::atomic<size_t> num_nodes{0};  // Allocated node slots
+        size_t max_nodes = 0;              // Node budget of this tree (0 = none)
+        std::unique_ptr<TranspositionTable<Node>> table;  // Null unless use_transpositions
+    };
+
+    // Scratch space of one search thread
+    struct WorkerContext {
+        std::unique_ptr<GameT> state;  // Root position walked with make/unmake (use_unmake only)
+        std::vector<int> moves;        // Moves applied to state in the current simulation
+        std::vector<Node*> path;       // Nodes of the current simulation, from the root
+        Xoshiro256* rng;
+        Tree* tree;
+        TreeArena* arena;              // Where this worker allocates new nodes
+        SearchCounters* counters;      // Statistics of the thread running this worker
+    };
+
+    // Simulations a pool worker claims from the budget at a time
+    static constexpr int SIMULATIONS_PER_TASK = 32;
+    // Seed of deterministic searches configured with seed 0
+    static constexpr uint64_t DETERMINISTIC_SEED = 0x2545f4914f6cdd1dULL;
+    // Plies below the previous root searched for the current position
+    static constexpr int MAX_REUSE_DEPTH = 2;
+
     Config config_;
+    std::shared_ptr<ThreadPool> pool_;
+    Xoshiro256 rng_;  // Generator of the calling thread for serial search
+    uint64_t base_seed_ = 0;  // config_.seed, or the seed drawn in its place
+    uint64_t searches_ = 0;   // Searches run so far
+    std::unique_ptr<Tree> tree_;  // Tree of the previous search (reuse_tree only)
+    std::unique_ptr<ConnectFourSolver> exact_solver_;  // Created on first use, keeping its table between moves
+
+    // Budget of the running search
+    std::chrono::steady_clock::time_point deadline_;
+    std::atomic<int> claimed_{0};       // Simulations handed out so far
+    std::atomic<int> simulations_{0};   // Simulations completed
+    std::atomic<bool> stop_requested_{false};
     
-    MCTSNode* select(MCTSNode* node);
-    MCTSNode* expand(MCTSNode* node);
-    int simulate(MCTSNode* node);
-    void backpropagate(MCTSNode* node, int reward);
-    
-    // Parallel simulation helpers
-    void parallelSimulate(MCTSNode* root, int num_threads);
-    void workerThread(MCTSNode* root, int num_simulations);
-    
-    // Heuristic evaluation
-    double evaluateState(const Game* state) const;
-    
+    // Statistics of the running search, one entry per thread, and the last
+    // completed search
+    std::vector<SearchCounters> counters_;
+    SearchStats stats_;
+
+    int search(GameT* game);
+    // The move for game, from a table, a tactic, the book, the exact solver
+    // or the tree search; search() wraps it with the bookkeeping
+    int chooseAction(GameT* game);
+
+    // Sets up arenas for num_workers workers and the root node for game
+    void initTree(Tree& tree, const GameT& game, int num_workers, size_t max_nodes) const;
+    static Node* createChildren(Tree& tree, TreeArena& arena, Node* parent);
+    static GameT* storeState(TreeArena& arena, const GameT& state);
+
+    // Moves tree's root to the node of game when the previous search reached
+    // it; false when the position is not found or the tree is out of node
+    // budget
+    bool rerootTree(Tree& tree, const GameT& game, int num_workers) const;
+    static Node* findPosition(Node* node, GameT& state, const GameT& target, int depth);
+
+    // Seed of the generator of one task of the current search, in
+    // deterministic mode: tasks get their own stream whichever worker runs them
+    uint64_t taskSeed(uint64_t task) const;
+
+    // Takes up to count simulations from the budget; returns how many were granted
+    int claimSimulations(int count);
+    // Whether the search must end: stop(), the deadline, the tree's node
+    // budget or a proven root
+    bool outOfBudget(const Tree& tree) const;
+
+    // One select/expand/simulate/backpropagate pass. In use_unmake mode the
+    // worker's state is walked from the root and restored before returning.
+    void runSimulation(Node* root, WorkerContext& worker);
+    WorkerContext makeWorker(const GameT& root_state, Xoshiro256& rng, Tree& tree, int worker_index,
+                             SearchCounters& counters) const;
+
+    // Selection and expansion from the root; returns the node to simulate from
+    Node* descend(Node* root, WorkerContext& worker, PhaseTimer& timer);
+    void restoreRoot(GameT* state, const std::vector<int>& moves) const;
+
+    Node* select(Node* node, WorkerContext& worker);
+    Node* expand(Node* node, WorkerContext& worker);
+    // Total reward of count rollouts from the node the worker reached
+    int playouts(Node* node, WorkerContext& worker, int count);
+    // Total reward of count rollouts from state; ConnectFour plays them as a batch
+    int simulate(const GameT& state, int count, Xoshiro256& rng);
+    int rollout(GameT* state, std::vector<int>* moves, Xoshiro256& rng);
+    // reward is for the side to move at the end of the path
+    void backpropagate(const std::vector<Node*>& path, int reward, int visits = 1);
+    // Proves the end of the path when it is terminal or all its children
+    // are proven, and carries new proofs up the path
+    void solve(const std::vector<Node*>& path, const GameT& leaf_state) const;
+    static int computeProof(const Node* node);
+    void addVirtualLoss(Node* node) const;
+
+    // Parallel simulation helpers; all of them run on the worker pool
+    ThreadPool& getPool();
+    void parallelSimulate(Tree& tree);
+    // Returns the node slots allocated by the private trees
+    size_t rootParallelSimulate(const GameT& game, std::vector<ActionStats>& totals);
+    void leafParallelSimulate(Tree& tree);
+
+    static void accumulateRootStats(const Node* root, std::vector<ActionStats>& totals);
+    // Adds counters_ and the wall time since start to stats_ once the
+    // search has ended
+    void collectStats(std::chrono::steady_clock::time_point start);
+
+    // Heuristic evaluation for player
+    double evaluateState(const GameT* state, int player) const;
+
     // Move ordering
-    void orderActions(std::vector<int>& actions, const Game* state) const;
-}; 
\ No newline at end of file
+    void orderActions(ActionList& actions, GameT* state) const;
+};
+
+using MCTS = BasicMCTS<Game>;
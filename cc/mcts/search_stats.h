@@ -0,0 +1,90 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+// Phase timings and lock waits cost a few clock reads per simulation.
+// Build with -DGAME_AI_SEARCH_STATS=0 to compile them out; the counters
+// below stay, and the timings then read 0.
+#ifndef GAME_AI_SEARCH_STATS
+#define GAME_AI_SEARCH_STATS 1
+#endif
+
+/**
+ * What the last search did, as reported by MCTSEngine::getSearchStats().
+ *
+ * Phase times are summed over all threads, so with several threads they can
+ * add up to more than the wall time. Lock wait is the time spent spinning on
+ * a node another thread was expanding, and is part of the expand time.
+ */
+struct SearchStats {
+    struct Thread {
+        int simulations = 0;    // Simulations run by this thread
+        long long playouts = 0; // Rollouts played by this thread
+        double busy_ms = 0;     // Time in the four search phases
+
+        double playoutsPerSecond(double wall_ms) const {
+            return wall_ms > 0 ? playouts * 1000.0 / wall_ms : 0;
+        }
+    };
+
+    int simulations = 0;
+    long long playouts = 0;
+    size_t nodes_allocated = 0;  // Node slots of the search trees, including reused ones
+    int max_depth = 0;           // Deepest node a simulation reached, in plies from the root
+    double avg_depth = 0;
+    bool solved = false;         // The value of the position was proven (use_solver only)
+    double value = 0;            // Expected reward of the chosen action for the side to move
+
+    double total_ms = 0;  // Wall time of selectAction
+    double select_ms = 0;
+    double expand_ms = 0;
+    double simulate_ms = 0;
+    double backpropagate_ms = 0;
+    double lock_wait_ms = 0;
+
+    // Pool workers in parallel search; the calling thread in serial search
+    // and, after the pool workers, in leaf search
+    std::vector<Thread> threads;
+};
+
+// Counters of one search thread, accumulated without synchronization and
+// merged into SearchStats when the search ends. Aligned to a cache line so
+// threads updating neighbouring entries do not contend.
+struct alignas(64) SearchCounters {
+    int simulations = 0;
+    long long playouts = 0;
+    long long depth_sum = 0;
+    int max_depth = 0;
+    long long select_ns = 0;
+    long long expand_ns = 0;
+    long long simulate_ns = 0;
+    long long backpropagate_ns = 0;
+    long long lock_wait_ns = 0;
+
+    // Depth reached by a number of simulations sharing one path
+    void addDepth(int depth, int count = 1) {
+        depth_sum += static_cast<long long>(depth) * count;
+        if (depth > max_depth) max_depth = depth;
+    }
+};
+
+// Splits a thread's time into consecutive phases: lap() charges the time
+// since the previous lap to one counter. Free when stats are compiled out.
+class PhaseTimer {
+public:
+#if GAME_AI_SEARCH_STATS
+    PhaseTimer() : last_(std::chrono::steady_clock::now()) {}
+
+    void lap(long long& total_ns) {
+        auto now = std::chrono::steady_clock::now();
+        total_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_).count();
+        last_ = now;
+    }
+
+private:
+    std::chrono::steady_clock::time_point last_;
+#else
+    void lap(long long&) {}
+#endif
+};
@@ -0,0 +1,128 @@
+#include "thread_pool.h"
+#include <algorithm>
+#include <random>
+
+ThreadPool::ThreadPool(int num_threads, uint64_t seed) {
+    num_threads = std::max(1, num_threads);
+
+    std::random_device rd;
+    for (int i = 0; i < num_threads; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+        // Distinct streams per worker; Xoshiro256::seed mixes the index in
+        queues_.back()->rng.seed(seed != 0 ? seed + i : (uint64_t(rd()) << 32) ^ rd());
+    }
+    for (int i = 0; i < num_threads; ++i) {
+        threads_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+void ThreadPool::run(std::vector<Task>& tasks, const std::atomic<bool>* cancel) {
+    if (tasks.empty()) return;
+    std::lock_guard<std::mutex> run_lock(run_mutex_);
+    failed_.store(false, std::memory_order_relaxed);
+    cancel_ = cancel;
+
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        auto& queue = *queues_[i % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(tasks[i]));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = static_cast<int>(tasks.size());
+        queued_ += static_cast<int>(tasks.size());
+    }
+    work_cv_.notify_all();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return pending_ == 0; });
+    if (error_) {
+        std::exception_ptr error = std::move(error_);
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::workerLoop(int worker) {
+    Task task;
+    while (true) {
+        {
+            // Claim one queued task before looking for it
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+            if (queued_ == 0) return;
+            --queued_;
+        }
+
+        // Every claim is backed by a task in some queue
+        while (!popTask(worker, task)) {
+            std::this_thread::yield();
+        }
+
+        if (!skipTasks()) {
+            try {
+                task(worker);
+            } catch (...) {
+                // Keep the worker alive and hand the first error to run()
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_) error_ = std::current_exception();
+                failed_.store(true, std::memory_order_relaxed);
+            }
+        }
+        task = nullptr;
+        finishTask();
+    }
+}
+
+bool ThreadPool::popTask(int worker, Task& task) {
+    // Newest task from our own queue first
+    {
+        auto& own = *queues_[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Otherwise steal the oldest task of another worker
+    int num_queues = static_cast<int>(queues_.size());
+    for (int i = 1; i < num_queues; ++i) {
+        auto& victim = *queues_[(worker + i) % num_queues];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::skipTasks() const {
+    return failed_.load(std::memory_order_relaxed) ||
+           (cancel_ && cancel_->load(std::memory_order_relaxed));
+}
+
+void ThreadPool::finishTask() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--pending_ == 0) {
+        done_cv_.notify_all();
+    }
+}
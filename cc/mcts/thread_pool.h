@@ -0,0 +1,72 @@
+#pragma once
+#include "../games/random.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Long-lived work-stealing pool for search batches.
+ *
+ * Each worker owns a task queue and a random number generator. A batch
+ * submitted with run() is spread round-robin over the queues; workers pop
+ * from the back of their own queue and steal from the front of the others
+ * when it runs dry. A task that throws skips the rest of its batch, and
+ * run() rethrows the exception on the caller's thread. A batch can also be
+ * cancelled through a flag the caller owns: its queued tasks are dropped,
+ * and running tasks are expected to poll the flag themselves.
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void(int worker)>;
+
+    // Worker generators are seeded from seed, or from std::random_device
+    // when it is 0
+    explicit ThreadPool(int num_threads, uint64_t seed = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(threads_.size()); }
+
+    // Runs every task and blocks until all of them have finished or been
+    // skipped, then rethrows the first exception a task threw. Tasks not yet
+    // started when *cancel becomes true are skipped. Batches from different
+    // callers are serialized.
+    void run(std::vector<Task>& tasks, const std::atomic<bool>* cancel = nullptr);
+
+    // Generator owned by a worker; only that worker may use it
+    Xoshiro256& rng(int worker) { return queues_[worker]->rng; }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        Xoshiro256 rng;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::mutex run_mutex_;     // One batch at a time
+    std::mutex mutex_;         // Guards pending_, queued_, stopping_ and error_
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    int pending_ = 0;          // Tasks of the current batch not yet finished
+    int queued_ = 0;           // Tasks sitting in the queues
+    bool stopping_ = false;
+    std::exception_ptr error_;          // First exception of the current batch
+    std::atomic<bool> failed_{false};   // Set with error_; later tasks are skipped
+    const std::atomic<bool>* cancel_ = nullptr;  // Cancel flag of the current batch, if any
+
+    void workerLoop(int worker);
+    bool popTask(int worker, Task& task);
+    void finishTask();
+    bool skipTasks() const;
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include "../games/random.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * Fixed-size, lock-free map from position keys to search nodes.
+ *
+ * NodeT must expose its key as `hash` and its visit count as
+ * `stats.visits`. The table only stores pointers; nodes must outlive it
+ * and must be fully initialized before they are inserted.
+ *
+ * Keys map to buckets of BUCKET_SIZE entries. When a bucket is full, the
+ * node with the fewest visits is replaced. Losing an entry is harmless: a
+ * later transposition to that position just gets a node of its own.
+ */
+template <typename NodeT>
+class TranspositionTable {
+public:
+    static constexpr size_t BUCKET_SIZE = 4;
+
+    // num_entries is rounded up to a power of two of at least BUCKET_SIZE
+    explicit TranspositionTable(size_t num_entries) {
+        size_t capacity = BUCKET_SIZE;
+        while (capacity < num_entries) capacity <<= 1;
+        entries_.reset(new std::atomic<NodeT*>[capacity]);
+        for (size_t i = 0; i < capacity; ++i) {
+            entries_[i].store(nullptr, std::memory_order_relaxed);
+        }
+        capacity_ = capacity;
+        bucket_mask_ = capacity / BUCKET_SIZE - 1;
+    }
+
+    NodeT* find(uint64_t key) const {
+        const std::atomic<NodeT*>* bucket = bucketOf(key);
+        for (size_t i = 0; i < BUCKET_SIZE; ++i) {
+            NodeT* node = bucket[i].load(std::memory_order_acquire);
+            if (node && node->hash == key) return node;
+        }
+        return nullptr;
+    }
+
+    void insert(NodeT* node) {
+        std::atomic<NodeT*>* bucket = bucketOf(node->hash);
+
+        // Take a free entry if there is one
+        for (size_t i = 0; i < BUCKET_SIZE; ++i) {
+            NodeT* expected = nullptr;
+            if (bucket[i].compare_exchange_strong(expected, node, std::memory_order_release,
+                                                  std::memory_order_relaxed)) {
+                return;
+            }
+        }
+
+        // Otherwise evict the least visited node
+        size_t victim = 0;
+        int fewest_visits = -1;
+        for (size_t i = 0; i < BUCKET_SIZE; ++i) {
+            NodeT* entry = bucket[i].load(std::memory_order_acquire);
+            int visits = entry ? entry->stats.visits.load(std::memory_order_relaxed) : 0;
+            if (fewest_visits < 0 || visits < fewest_visits) {
+                fewest_visits = visits;
+                victim = i;
+            }
+        }
+        bucket[victim].store(node, std::memory_order_release);
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    std::unique_ptr<std::atomic<NodeT*>[]> entries_;
+    size_t capacity_;
+    size_t bucket_mask_;
+
+    std::atomic<NodeT*>* bucketOf(uint64_t key) const {
+        // The game keys are exact but poorly distributed
+        return &entries_[(mix64(key) & bucket_mask_) * BUCKET_SIZE];
+    }
+};
@@ -0,0 +1,49 @@
+#include "../mcts/arena.h"
+#include <gtest/gtest.h>
+#include <memory>
+
+TEST(ArenaTest, CreateTest) {
+    Arena<int> arena(4);
+    std::vector<int*> values;
+    for (int i = 0; i < 10; ++i) {
+        values.push_back(arena.create(i));
+    }
+    
+    EXPECT_EQ(arena.size(), 10u);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(*values[i], i);
+    }
+}
+
+TEST(ArenaTest, CreateRangeTest) {
+    Arena<int> arena(4);
+    arena.create(0);
+    
+    // A range that does not fit the current block starts a new one, and a
+    // range larger than a block gets a block of its own
+    int* small = arena.createRange(4, 7);
+    int* large = arena.createRange(9, 3);
+    for (int i = 0; i < 4; ++i) EXPECT_EQ(small[i], 7);
+    for (int i = 0; i < 9; ++i) EXPECT_EQ(large[i], 3);
+    EXPECT_EQ(arena.size(), 14u);
+}
+
+TEST(ArenaTest, ClearRunsDestructorsTest) {
+    auto counter = std::make_shared<int>(0);
+    {
+        Arena<std::shared_ptr<int>> arena(2);
+        for (int i = 0; i < 5; ++i) {
+            arena.create(counter);
+        }
+        EXPECT_EQ(counter.use_count(), 6);
+        
+        arena.clear();
+        EXPECT_EQ(counter.use_count(), 1);
+        EXPECT_EQ(arena.size(), 0u);
+        
+        // The arena is usable again after a clear
+        arena.create(counter);
+        EXPECT_EQ(counter.use_count(), 2);
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+}
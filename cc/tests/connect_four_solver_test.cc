@@ -0,0 +1,149 @@
+#include "../games/connect_four_solver.h"
+#include "../mcts/mcts.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+
+namespace {
+
+// Plain negamax over every move, scored like ConnectFourSolver
+int bruteForce(ConnectFour& game) {
+    ActionList actions;
+    game.generateActions(actions);
+    int best = -ConnectFourSolver::WIN_SCORE;
+    for (int action : actions) {
+        int player = game.getCurrentPlayer();
+        game.makeMove(action);
+        int score;
+        if (game.isGameOver()) {
+            score = game.getWinner() == player ? ConnectFourSolver::WIN_SCORE - game.getMoveCount() : 0;
+        } else {
+            score = -bruteForce(game);
+        }
+        game.unmakeMove(action);
+        best = std::max(best, score);
+    }
+    return best;
+}
+
+} // namespace
+
+class ConnectFourSolverTest : public ::testing::Test {
+protected:
+    ConnectFour play(std::initializer_list<int> moves) {
+        ConnectFour game(1);
+        for (int move : moves) {
+            game.makeMove(move);
+        }
+        return game;
+    }
+
+    ConnectFourSolver solver{1 << 16};
+};
+
+TEST_F(ConnectFourSolverTest, ImmediateWinTest) {
+    ConnectFour game = play({0, 6, 1, 6, 2, 6});
+    auto result = solver.solve(game);
+    EXPECT_EQ(result.move, 3);
+    EXPECT_EQ(result.score, ConnectFourSolver::WIN_SCORE - 7);
+    EXPECT_TRUE(result.exact);
+}
+
+TEST_F(ConnectFourSolverTest, ForcedWinTest) {
+    // Column 3 makes an open three on the bottom row
+    ConnectFour game = play({1, 6, 2, 6});
+    auto result = solver.solve(game);
+    EXPECT_EQ(result.move, 3);
+    EXPECT_EQ(result.score, ConnectFourSolver::WIN_SCORE - 7);
+    EXPECT_TRUE(result.exact);
+
+    // The side facing it has lost
+    game.makeMove(3);
+    result = solver.solve(game);
+    EXPECT_EQ(result.score, -(ConnectFourSolver::WIN_SCORE - 7));
+    EXPECT_TRUE(result.exact);
+}
+
+TEST_F(ConnectFourSolverTest, MatchesBruteForceTest) {
+    // Endgames of random games, where every move can be tried
+    std::mt19937 rng(7);
+    int positions = 0;
+    while (positions < 40) {
+        ConnectFour game(1);
+        while (!game.isGameOver() && game.getMoveCount() < 34) {
+            ActionList actions;
+            game.generateActions(actions);
+            game.makeMove(actions[rng() % actions.size()]);
+        }
+        if (game.isGameOver()) continue;
+        ++positions;
+
+        int expected = bruteForce(game);
+        auto result = solver.solve(game);
+        ASSERT_TRUE(result.exact);
+        EXPECT_EQ(result.score, expected);
+
+        // The move reaches the score
+        int player = game.getCurrentPlayer();
+        game.makeMove(result.move);
+        int reached = game.isGameOver()
+            ? (game.getWinner() == player ? ConnectFourSolver::WIN_SCORE - game.getMoveCount() : 0)
+            : -bruteForce(game);
+        EXPECT_EQ(reached, expected);
+    }
+}
+
+TEST_F(ConnectFourSolverTest, DeadlineTest) {
+    // The empty board is far beyond any deadline
+    ConnectFour game(1);
+    auto result = solver.solve(game, std::chrono::steady_clock::now());
+    EXPECT_FALSE(result.exact);
+    EXPECT_GE(result.move, 0);
+    EXPECT_LT(result.move, ConnectFour::COLS);
+    EXPECT_GE(result.depth, 1);
+
+    EXPECT_EQ(solver.solve(play({0, 6, 1, 6, 2, 6, 3})).move, -1);
+}
+
+TEST_F(ConnectFourSolverTest, SearchHandOffTest) {
+    MCTSConfig config;
+    config.num_threads = 1;
+    config.exact_solver_threshold = ConnectFour::ROWS * ConnectFour::COLS;
+
+    ConnectFour game = play({1, 6, 2, 6});
+    BasicMCTS<ConnectFour> search(config);
+    EXPECT_EQ(search.selectAction(&game), 3);
+    EXPECT_EQ(search.getSimulationCount(), 0);
+    EXPECT_TRUE(search.getSearchStats().solved);
+    EXPECT_DOUBLE_EQ(search.getSearchStats().value, 1.0);
+
+    // The search over the virtual interface hands off too
+    MCTS virtual_search(config);
+    EXPECT_EQ(virtual_search.selectAction(&game), 3);
+    EXPECT_EQ(virtual_search.getSimulationCount(), 0);
+
+    // Positions with more empty cells are searched
+    config.exact_solver_threshold = 10;
+    config.num_simulations = 100;
+    search.setConfig(config);
+    EXPECT_GE(search.selectAction(&game), 0);
+    EXPECT_EQ(search.getSimulationCount(), 100);
+}
+
+TEST_F(ConnectFourSolverTest, SearchHandOffDeadlineTest) {
+    // The empty board cannot be solved in the budget; the deepest completed
+    // iteration keeps the center column first
+    MCTSConfig config;
+    config.num_threads = 1;
+    config.exact_solver_threshold = ConnectFour::ROWS * ConnectFour::COLS + 1;
+    config.time_limit_ms = 20;
+
+    ConnectFour game(1);
+    for (uint64_t seed = 1; seed <= 5; ++seed) {
+        config.seed = seed;
+        BasicMCTS<ConnectFour> search(config);
+        EXPECT_EQ(search.selectAction(&game), 3);
+        EXPECT_FALSE(search.getSearchStats().solved);
+        EXPECT_EQ(search.getSimulationCount(), 0);
+    }
+}
@@ -0,0 +1,387 @@
+#include "../games/connect_four.h"
+#include "../games/connect_four_rollouts.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+class ConnectFourTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        game = std::make_unique<ConnectFour>(1);
+    }
+
+    void play(std::initializer_list<int> moves) {
+        for (int move : moves) {
+            game->makeMove(move);
+        }
+    }
+
+    std::unique_ptr<ConnectFour> game;
+};
+
+TEST_F(ConnectFourTest, ConstructorTest) {
+    EXPECT_EQ(game->getCurrentPlayer(), 1);
+    EXPECT_EQ(game->getBoardSize(), 42);
+    EXPECT_EQ(game->getGameName(), "Connect Four");
+    EXPECT_FALSE(game->isGameOver());
+
+    // Test invalid starting player
+    EXPECT_THROW(ConnectFour(0), std::invalid_argument);
+    EXPECT_THROW(ConnectFour(3), std::invalid_argument);
+}
+
+TEST_F(ConnectFourTest, PossibleActionsTest) {
+    EXPECT_EQ(game->getPossibleActions().size(), 7);
+
+    // Fill column 3
+    play({3, 3, 3, 3, 3, 3});
+    auto actions = game->getPossibleActions();
+    EXPECT_EQ(actions.size(), 6);
+    EXPECT_EQ(std::find(actions.begin(), actions.end(), 3), actions.end());
+
+    // Moves into a full column are ignored
+    game->makeMove(3);
+    EXPECT_EQ(game->getCurrentPlayer(), 1);
+
+    ActionList list;
+    game->generateActions(list);
+    ASSERT_EQ(list.size(), static_cast<int>(actions.size()));
+    EXPECT_TRUE(std::equal(list.begin(), list.end(), actions.begin()));
+}
+
+TEST_F(ConnectFourTest, WinConditionsTest) {
+    // Horizontal
+    play({0, 0, 1, 1, 2, 2, 3});
+    EXPECT_TRUE(game->isGameOver());
+    EXPECT_EQ(game->getReward(1), 1);
+    EXPECT_EQ(game->getReward(2), -1);
+
+    // Vertical
+    game = std::make_unique<ConnectFour>(1);
+    play({0, 1, 0, 1, 0, 1, 0});
+    EXPECT_TRUE(game->isGameOver());
+    EXPECT_EQ(game->getReward(1), 1);
+
+    // Diagonal (positive slope)
+    game = std::make_unique<ConnectFour>(1);
+    play({0, 1, 1, 2, 2, 3, 2, 3, 3, 6, 3});
+    EXPECT_TRUE(game->isGameOver());
+    EXPECT_EQ(game->getReward(1), 1);
+
+    // Diagonal (negative slope)
+    game = std::make_unique<ConnectFour>(1);
+    play({6, 5, 5, 4, 4, 3, 4, 3, 3, 0, 3});
+    EXPECT_TRUE(game->isGameOver());
+    EXPECT_EQ(game->getReward(1), 1);
+}
+
+TEST_F(ConnectFourTest, NoWrapAcrossColumnsTest) {
+    // Three stones at the top of column 0 and one at the bottom of column 1
+    // would be adjacent in bit order without the sentinel row
+    play({6, 0, 6, 0, 6, 0, 0, 5, 0, 5, 0, 5, 1});
+    EXPECT_FALSE(game->isGameOver());
+}
+
+TEST_F(ConnectFourTest, DrawTest) {
+    // Fill the board column pairs in an order that never makes four in a row
+    for (int col : {0, 2, 4}) {
+        play({col, col + 1, col, col + 1, col, col + 1});
+        play({col + 1, col, col + 1, col, col + 1, col});
+    }
+    play({6, 6, 6, 6, 6, 6});
+    EXPECT_TRUE(game->isGameOver());
+    EXPECT_TRUE(game->getPossibleActions().empty());
+    EXPECT_EQ(game->getReward(1), 0);
+    EXPECT_EQ(game->getReward(2), 0);
+}
+
+TEST_F(ConnectFourTest, WinningMoveTest) {
+    play({0, 0, 1, 1, 2, 2});
+    EXPECT_TRUE(game->isWinningMove(3));
+    EXPECT_FALSE(game->isWinningMove(4));
+    EXPECT_FALSE(game->isWinningMove(-1));
+    EXPECT_FALSE(game->isGameOver());
+}
+
+TEST_F(ConnectFourTest, TacticalMovesTest) {
+    ActionList wins;
+    ActionList blocks;
+
+    // Player 1 completes the bottom row; column 3 would also be unsafe, as
+    // player 2 threatens the cell above it
+    play({0, 0, 1, 1, 2, 2});
+    game->generateTacticalMoves(wins, blocks);
+    ASSERT_EQ(wins.size(), 1);
+    EXPECT_EQ(wins[0], 3);
+    EXPECT_FALSE(blocks.contains(3));
+    EXPECT_EQ(blocks.size(), 6);
+
+    // Player 2 must block column 3
+    game = std::make_unique<ConnectFour>(1);
+    play({0, 6, 1, 6, 2});
+    game->generateTacticalMoves(wins, blocks);
+    EXPECT_TRUE(wins.empty());
+    ASSERT_EQ(blocks.size(), 1);
+    EXPECT_EQ(blocks[0], 3);
+
+    // Two open ends cannot both be blocked
+    game = std::make_unique<ConnectFour>(1);
+    play({1, 6, 2, 6, 3});
+    game->generateTacticalMoves(wins, blocks);
+    EXPECT_TRUE(wins.empty());
+    EXPECT_TRUE(blocks.empty());
+}
+
+TEST_F(ConnectFourTest, TacticalMovesMatchDefaultTest) {
+    // The bitboard threat detection agrees with trying every move
+    auto sorted = [](const ActionList& actions) {
+        std::vector<int> result(actions.begin(), actions.end());
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+    Xoshiro256 rng(7);
+    ActionList actions, wins, blocks, expected_wins, expected_blocks;
+
+    for (int game_index = 0; game_index < 200; ++game_index) {
+        ConnectFour position(1);
+        while (!position.isGameOver()) {
+            position.generateTacticalMoves(wins, blocks);
+            position.Game::generateTacticalMoves(expected_wins, expected_blocks);
+            ASSERT_EQ(sorted(wins), sorted(expected_wins));
+            // Once a move wins, the safety of the others no longer matters
+            if (wins.empty()) {
+                ASSERT_EQ(sorted(blocks), sorted(expected_blocks));
+            }
+
+            position.generateActions(actions);
+            position.makeMove(actions[rng.below(actions.size())]);
+        }
+    }
+}
+
+TEST_F(ConnectFourTest, CloneTest) {
+    play({3, 4});
+    auto clone = game->clone();
+    EXPECT_EQ(clone->serialize(), game->serialize());
+
+    clone->makeMove(3);
+    EXPECT_NE(clone->serialize(), game->serialize());
+}
+
+TEST_F(ConnectFourTest, UnmakeMoveTest) {
+    play({3, 3, 4, 4, 5, 5});
+    std::string before = game->serialize();
+
+    // Undoing a winning move restores the previous position
+    game->makeMove(2);
+    EXPECT_TRUE(game->isGameOver());
+    game->unmakeMove(2);
+    EXPECT_FALSE(game->isGameOver());
+    EXPECT_EQ(game->serialize(), before);
+    EXPECT_EQ(game->getCurrentPlayer(), 1);
+
+    for (int col : {5, 5, 4, 4, 3, 3}) {
+        game->unmakeMove(col);
+    }
+    EXPECT_EQ(game->serialize(), ConnectFour(1).serialize());
+}
+
+TEST_F(ConnectFourTest, IncrementalStateTest) {
+    // The winner and move count follow makeMove and unmakeMove
+    play({0, 1, 0, 1, 0, 1});
+    EXPECT_EQ(game->getWinner(), 0);
+    EXPECT_EQ(game->getMoveCount(), 6);
+    game->makeMove(0);
+    EXPECT_EQ(game->getWinner(), 1);
+    EXPECT_EQ(game->getReward(1), 1);
+    EXPECT_EQ(game->getReward(2), -1);
+    game->unmakeMove(0);
+    EXPECT_EQ(game->getWinner(), 0);
+    EXPECT_EQ(game->getMoveCount(), 6);
+
+    // Moves into a full column change nothing
+    ConnectFour column(1);
+    for (int i = 0; i < ConnectFour::ROWS + 1; ++i) column.makeMove(6);
+    EXPECT_EQ(column.getMoveCount(), ConnectFour::ROWS);
+
+    // Deserialized positions derive both from the board
+    game->makeMove(0);
+    ConnectFour restored(1);
+    ASSERT_TRUE(restored.deserialize(game->serialize()));
+    EXPECT_EQ(restored.getWinner(), 1);
+    EXPECT_EQ(restored.getMoveCount(), 7);
+    EXPECT_TRUE(restored.isGameOver());
+}
+
+TEST_F(ConnectFourTest, HashTest) {
+    // The same position reached through different move orders
+    ConnectFour other(1);
+    play({3, 2, 4, 3});
+    for (int col : {4, 2, 3, 3}) other.makeMove(col);
+    EXPECT_EQ(game->getHash(), other.getHash());
+
+    // Stones of the other player or the other side to move differ
+    ConnectFour swapped(1);
+    for (int col : {2, 3, 3, 4}) swapped.makeMove(col);
+    EXPECT_NE(game->getHash(), swapped.getHash());
+    EXPECT_NE(ConnectFour(1).getHash(), ConnectFour(2).getHash());
+
+    game->makeMove(0);
+    EXPECT_NE(game->getHash(), other.getHash());
+    game->unmakeMove(0);
+    EXPECT_EQ(game->getHash(), other.getHash());
+}
+
+TEST_F(ConnectFourTest, SerializationTest) {
+    play({3, 3, 4, 2});
+    std::string state = game->serialize();
+
+    ConnectFour restored(1);
+    EXPECT_TRUE(restored.deserialize(state));
+    EXPECT_EQ(restored.serialize(), state);
+    EXPECT_EQ(restored.getCurrentPlayer(), game->getCurrentPlayer());
+    EXPECT_EQ(restored.getPlayerBoard(1), game->getPlayerBoard(1));
+    EXPECT_EQ(restored.getPlayerBoard(2), game->getPlayerBoard(2));
+
+    // Floating stones are rejected
+    std::string floating = "1 1";
+    for (int i = 1; i < ConnectFour::ROWS * ConnectFour::COLS; ++i) floating += " 0";
+    EXPECT_FALSE(restored.deserialize(floating));
+    EXPECT_FALSE(restored.deserialize("garbage"));
+}
+
+TEST_F(ConnectFourTest, BinarySerializationTest) {
+    play({3, 3, 4, 2, 3, 3, 3, 3, 0});
+    uint8_t buffer[Game::MAX_BINARY_SIZE];
+    size_t size = game->serializeBinary(buffer, sizeof(buffer));
+    ASSERT_GT(size, 0u);
+    EXPECT_LT(size * 8, game->serialize().size());
+    EXPECT_EQ(buffer[0], Game::BINARY_FORMAT_VERSION);
+
+    ConnectFour restored(1);
+    EXPECT_TRUE(restored.deserializeBinary(buffer, size));
+    EXPECT_EQ(restored.serialize(), game->serialize());
+    EXPECT_EQ(restored.getHash(), game->getHash());
+    EXPECT_EQ(restored.getMoveCount(), game->getMoveCount());
+    EXPECT_DOUBLE_EQ(restored.evaluatePosition(), game->evaluatePosition());
+
+    // Full columns and finished games round-trip too
+    play({1, 0, 1, 0, 1, 0});
+    ASSERT_TRUE(game->isGameOver());
+    size = game->serializeBinary(buffer, sizeof(buffer));
+    EXPECT_TRUE(restored.deserializeBinary(buffer, size));
+    EXPECT_EQ(restored.getWinner(), 1);
+    EXPECT_EQ(restored.serialize(), game->serialize());
+
+    // Short buffers, other versions and malformed boards are rejected
+    EXPECT_EQ(game->serializeBinary(buffer, size - 1), 0u);
+    EXPECT_FALSE(restored.deserializeBinary(buffer, size - 1));
+    uint8_t invalid[Game::MAX_BINARY_SIZE];
+    std::copy(buffer, buffer + size, invalid);
+    invalid[0] = Game::BINARY_FORMAT_VERSION + 1;
+    EXPECT_FALSE(restored.deserializeBinary(invalid, size));
+    std::copy(buffer, buffer + size, invalid);
+    invalid[1] = 3;
+    EXPECT_FALSE(restored.deserializeBinary(invalid, size));
+    std::fill(invalid + 2, invalid + size, 0);
+    EXPECT_FALSE(restored.deserializeBinary(invalid, size));
+    EXPECT_EQ(restored.serialize(), game->serialize());
+}
+
+TEST_F(ConnectFourTest, EvaluatePositionTest) {
+    EXPECT_DOUBLE_EQ(game->evaluatePosition(), 0.0);
+
+    // A single stone in the bottom-left corner lies in 3 windows
+    game->makeMove(0);
+    EXPECT_DOUBLE_EQ(game->evaluatePosition(), 30.0);
+
+    // The same stone for player 2 scores symmetrically
+    ConnectFour other(2);
+    other.makeMove(0);
+    EXPECT_DOUBLE_EQ(other.evaluatePosition(), -30.0);
+}
+
+TEST_F(ConnectFourTest, IncrementalEvaluationTest) {
+    // The score kept by makeMove and unmakeMove matches a full rescan,
+    // which deserialize performs
+    Xoshiro256 rng(3);
+    ActionList actions;
+    ConnectFour restored(1);
+    for (int game_index = 0; game_index < 50; ++game_index) {
+        ConnectFour position(1);
+        std::vector<double> scores{position.evaluatePosition()};
+        std::vector<int> moves;
+        while (!position.isGameOver()) {
+            position.generateActions(actions);
+            int action = actions[rng.below(actions.size())];
+            position.makeMove(action);
+            moves.push_back(action);
+            scores.push_back(position.evaluatePosition());
+
+            ASSERT_TRUE(restored.deserialize(position.serialize()));
+            ASSERT_DOUBLE_EQ(position.evaluatePosition(), restored.evaluatePosition());
+        }
+
+        // Unmaking walks back through the same scores
+        while (!moves.empty()) {
+            scores.pop_back();
+            position.unmakeMove(moves.back());
+            moves.pop_back();
+            ASSERT_DOUBLE_EQ(position.evaluatePosition(), scores.back());
+        }
+    }
+}
+
+TEST_F(ConnectFourTest, BatchFindWinsTest) {
+    // An odd lane count covers the vector loops and the scalar tail
+    std::mt19937_64 rng(7);
+    uint64_t boards[37];
+    uint64_t wins[37];
+    for (uint64_t& board : boards) {
+        board = rng() & rng() & ConnectFour::BOARD_MASK;
+    }
+    ConnectFourRollouts::findWins(boards, wins, 37);
+    for (int i = 0; i < 37; ++i) {
+        EXPECT_EQ(wins[i] != 0, ConnectFour::hasFour(boards[i])) << "lane " << i;
+    }
+}
+
+TEST_F(ConnectFourTest, BatchRolloutTest) {
+    Xoshiro256 rng(1);
+
+    // Finished games score the reward of the side to move for every rollout
+    play({3, 3, 4, 4, 5, 5, 2});
+    EXPECT_EQ(ConnectFourRollouts::play(*game, 5, rng), -5);
+
+    // The last free cell of the drawn board can only be a draw
+    game = std::make_unique<ConnectFour>(1);
+    for (int col : {0, 2, 4}) {
+        play({col, col + 1, col, col + 1, col, col + 1});
+        play({col + 1, col, col + 1, col, col + 1, col});
+    }
+    play({6, 6, 6, 6, 6});
+    EXPECT_EQ(ConnectFourRollouts::play(*game, 40, rng), 0);
+
+    // Rewards are for the side to move in the starting position
+    game = std::make_unique<ConnectFour>(1);
+    // Player 1 to move, with three stones stacked in column 0
+    play({0, 1, 0, 1, 0, 2});
+    EXPECT_GT(ConnectFourRollouts::play(*game, 1000, rng), 300);
+
+    // From the empty board the batch matches one-at-a-time random games
+    game = std::make_unique<ConnectFour>(1);
+    const int games = 20000;
+    int batch_total = ConnectFourRollouts::play(*game, games, rng);
+
+    int scalar_total = 0;
+    for (int i = 0; i < games; ++i) {
+        ConnectFour rollout(1);
+        while (!rollout.isGameOver()) {
+            auto actions = rollout.getPossibleActions();
+            rollout.makeMove(actions[rng.below(actions.size())]);
+        }
+        scalar_total += rollout.getReward(1);
+    }
+    EXPECT_NEAR(static_cast<double>(batch_total) / games, static_cast<double>(scalar_total) / games, 0.02);
+}
@@ -0,0 +1,87 @@
+#include "../mcts/mcts.h"
+#include "search_test_positions.h"
+#include <gtest/gtest.h>
+
+class MCTSSolverTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        config.num_simulations = 1000;
+        config.use_heuristic = true;
+        config.use_move_ordering = true;
+        config.num_threads = 1;
+    }
+
+    MCTSConfig config;
+};
+
+TEST_F(MCTSSolverTest, SolverTest) {
+    config.use_solver = true;
+    config.num_simulations = 100000;
+    MCTS search(config);
+    TicTacToe fork = ticTacToeForkPosition();
+    EXPECT_EQ(search.selectAction(&fork), 8);
+    EXPECT_TRUE(search.getSearchStats().solved);
+    EXPECT_LT(search.getSimulationCount(), config.num_simulations);
+
+    // With transpositions the whole game is proven from the empty board
+    config.use_transpositions = true;
+    BasicMCTS<TicTacToe> full_search(config);
+    TicTacToe empty(1);
+    EXPECT_GE(full_search.selectAction(&empty), 0);
+    EXPECT_TRUE(full_search.getSearchStats().solved);
+    EXPECT_DOUBLE_EQ(full_search.getSearchStats().value, 0.0);
+    EXPECT_LT(full_search.getSimulationCount(), config.num_simulations);
+}
+
+TEST_F(MCTSSolverTest, SolverSearchModesTest) {
+    using Mode = MCTSConfig::SearchMode;
+    config.use_solver = true;
+    config.use_move_ordering = false;
+    config.num_simulations = 50000;
+    config.num_threads = 4;
+
+    for (Mode mode : {Mode::Tree, Mode::Root, Mode::Leaf}) {
+        SCOPED_TRACE(testing::Message() << "mode " << static_cast<int>(mode));
+        config.search_mode = mode;
+        ConnectFour position = connectFourOpenThreePosition();
+        BasicMCTS<ConnectFour> search(config);
+        EXPECT_EQ(search.selectAction(&position), 3);
+        EXPECT_TRUE(search.getSearchStats().solved);
+        EXPECT_LT(search.getSimulationCount(), config.num_simulations);
+    }
+}
+
+TEST_F(MCTSSolverTest, PerfectPlayTest) {
+    config.use_perfect_play = true;
+    MCTS search(config);
+    TicTacToe fork = ticTacToeForkPosition();
+    EXPECT_EQ(search.selectAction(&fork), 8);
+    EXPECT_EQ(search.getSimulationCount(), 0);
+    EXPECT_TRUE(search.getSearchStats().solved);
+    EXPECT_DOUBLE_EQ(search.getSearchStats().value, 1.0);
+
+    // Games without a table are searched
+    ConnectFour connect_four(1);
+    EXPECT_GE(search.selectAction(&connect_four), 0);
+    EXPECT_EQ(search.getSimulationCount(), config.num_simulations);
+}
+
+TEST_F(MCTSSolverTest, StrengthAgainstPerfectPlayTest) {
+    // The search never loses to perfect play from either side
+    config.seed = 1;
+    BasicMCTS<TicTacToe> search(config);
+    for (int search_player : {1, 2}) {
+        TicTacToe position(1);
+        while (!position.isGameOver()) {
+            int action;
+            int value;
+            if (position.getCurrentPlayer() == search_player) {
+                action = search.selectAction(&position);
+            } else {
+                ASSERT_TRUE(position.lookupPerfectPlay(action, value));
+            }
+            position.makeMove(action);
+        }
+        EXPECT_GE(position.getReward(search_player), 0);
+    }
+}
@@ -1,7 +1,10 @@
 #include "../mcts/mcts.h"
 #include "../games/tic_tac_toe.h"
+#include "../games/connect_four.h"
+#include "search_test_positions.h"
 #include <gtest/gtest.h>
 #include <memory>
+#include <chrono>
 
 class MCTSTest : public ::testing::Test {
 protected:
@@ -56,6 +59,39 @@ TEST_F(MCTSTest, BlockingMoveTest) {
     EXPECT_EQ(action, 7); // The blocking move
 }
 
+TEST_F(MCTSTest, MustBlockTest) {
+    // O threatens the middle column and X has no win
+    game->makeMove(0); // X
+    game->makeMove(4); // O
+    game->makeMove(8); // X
+    game->makeMove(1); // O
+    EXPECT_EQ(mcts->selectAction(game.get()), 7);
+    
+    // Player 2 must stop the bottom row in column 3
+    ConnectFour connect_four(1);
+    for (int move : {0, 6, 1, 6, 2}) connect_four.makeMove(move);
+    BasicMCTS<ConnectFour> search(config);
+    EXPECT_EQ(search.selectAction(&connect_four), 3);
+    EXPECT_EQ(search.getSimulationCount(), 0);
+}
+
+TEST_F(MCTSTest, RewardPerspectiveTest) {
+    // X wins by force only with 8, which opens two lines at once. Neither
+    // side can win at once, so only the search statistics find it: each
+    // child must be scored for X, who moves into it.
+    game->makeMove(0); // X
+    game->makeMove(1); // O
+    game->makeMove(2); // X
+    game->makeMove(6); // O
+
+    for (bool use_unmake : {false, true}) {
+        config.use_unmake = use_unmake;
+        config.num_simulations = 2000;
+        mcts = std::make_unique<MCTS>(config);
+        EXPECT_EQ(mcts->selectAction(game.get()), 8);
+    }
+}
+
 TEST_F(MCTSTest, ParallelSimulationTest) {
     config.num_threads = 4;
     mcts = std::make_unique<MCTS>(config);
@@ -65,6 +101,22 @@ TEST_F(MCTSTest, ParallelSimulationTest) {
     EXPECT_LT(action, 9);
 }
 
+TEST_F(MCTSTest, SpecializedSearchTest) {
+    TicTacToe fork = ticTacToeForkPosition();
+    BasicMCTS<TicTacToe> ttt_search(config);
+    EXPECT_EQ(ttt_search.selectAction(&fork), 8);
+    EXPECT_EQ(ttt_search.getSimulationCount(), config.num_simulations);
+    
+    ConnectFour open_three = connectFourOpenThreePosition();
+    config.use_unmake = true;
+    BasicMCTS<ConnectFour> c4_search(config);
+    EXPECT_EQ(c4_search.selectAction(&open_three), 3);
+    EXPECT_EQ(c4_search.getSimulationCount(), config.num_simulations);
+    
+    // A search specialized for one game rejects the other
+    EXPECT_EQ(ttt_search.selectAction(&open_three), -1);
+}
+
 TEST_F(MCTSTest, MoveOrderingTest) {
     // Set up a position with multiple possible moves
     game->makeMove(0); // X
@@ -0,0 +1,129 @@
+#include "../games/opening_book.h"
+#include "../mcts/mcts.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace {
+
+OpeningBook::Entry makeEntry(const ConnectFour& game, int move, double value) {
+    OpeningBook::Entry entry;
+    entry.key = OpeningBook::keyOf(game);
+    entry.value = static_cast<int16_t>(value * 1000);
+    entry.move = static_cast<int8_t>(move);
+    entry.depth = static_cast<uint8_t>(game.getMoveCount());
+    entry.simulations = 0;
+    return entry;
+}
+
+} // namespace
+
+class OpeningBookTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = ::testing::TempDir() + "opening_book_test.book";
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    std::string path;
+};
+
+TEST_F(OpeningBookTest, LookupTest) {
+    // Every position after two moves, plus the empty board
+    std::vector<OpeningBook::Entry> entries;
+    ConnectFour empty(1);
+    entries.push_back(makeEntry(empty, 3, 0.1));
+    for (int first = 0; first < ConnectFour::COLS; ++first) {
+        for (int second = 0; second < ConnectFour::COLS; ++second) {
+            ConnectFour game(1);
+            game.makeMove(first);
+            game.makeMove(second);
+            entries.push_back(makeEntry(game, (first + second) % ConnectFour::COLS, -0.25));
+        }
+    }
+    ASSERT_TRUE(OpeningBook::write(path, entries));
+
+    OpeningBook book;
+    ASSERT_TRUE(book.open(path));
+    EXPECT_EQ(book.size(), entries.size());
+
+    const OpeningBook::Entry* entry = book.find(empty);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->move, 3);
+    EXPECT_EQ(entry->value, 100);
+
+    for (int first = 0; first < ConnectFour::COLS; ++first) {
+        for (int second = 0; second < ConnectFour::COLS; ++second) {
+            ConnectFour game(1);
+            game.makeMove(first);
+            game.makeMove(second);
+            entry = book.find(game);
+            ASSERT_NE(entry, nullptr);
+            EXPECT_EQ(entry->move, (first + second) % ConnectFour::COLS);
+            EXPECT_EQ(entry->depth, 2);
+        }
+    }
+
+    // Positions outside the book
+    ConnectFour one_move(1);
+    one_move.makeMove(0);
+    EXPECT_EQ(book.find(one_move), nullptr);
+    EXPECT_EQ(book.find(ConnectFour(2)), nullptr);
+
+    book.close();
+    EXPECT_FALSE(book.isOpen());
+    EXPECT_EQ(book.find(empty), nullptr);
+}
+
+TEST_F(OpeningBookTest, InvalidFileTest) {
+    OpeningBook book;
+    EXPECT_FALSE(book.open(path));
+
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "not an opening book at all";
+    }
+    EXPECT_FALSE(book.open(path));
+
+    // A truncated book is rejected
+    ASSERT_TRUE(OpeningBook::write(path, {makeEntry(ConnectFour(1), 3, 0.0)}));
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        file << "x";
+    }
+    EXPECT_FALSE(book.open(path));
+    EXPECT_FALSE(book.isOpen());
+}
+
+TEST_F(OpeningBookTest, SearchUsesBookTest) {
+    // An unusual book move shows that no search ran
+    ASSERT_TRUE(OpeningBook::write(path, {makeEntry(ConnectFour(1), 0, 0.5)}));
+    auto book = std::make_shared<OpeningBook>();
+    ASSERT_TRUE(book->open(path));
+
+    MCTSConfig config;
+    config.num_threads = 1;
+    config.opening_book = book;
+
+    ConnectFour game(1);
+    BasicMCTS<ConnectFour> search(config);
+    EXPECT_EQ(search.selectAction(&game), 0);
+    EXPECT_EQ(search.getSimulationCount(), 0);
+    EXPECT_DOUBLE_EQ(search.getSearchStats().value, 0.5);
+
+    // The search over the virtual interface probes it too
+    MCTS virtual_search(config);
+    EXPECT_EQ(virtual_search.selectAction(&game), 0);
+
+    // Positions outside the book are searched
+    game.makeMove(3);
+    config.num_simulations = 100;
+    search.setConfig(config);
+    EXPECT_GE(search.selectAction(&game), 0);
+    EXPECT_EQ(search.getSimulationCount(), 100);
+}
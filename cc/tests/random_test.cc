@@ -0,0 +1,45 @@
+#include "../games/random.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(RandomTest, SeedTest) {
+    Xoshiro256 a(42);
+    Xoshiro256 b(42);
+    Xoshiro256 c(43);
+    
+    bool differs = false;
+    for (int i = 0; i < 100; ++i) {
+        uint64_t value = a();
+        EXPECT_EQ(value, b());
+        differs |= value != c();
+    }
+    EXPECT_TRUE(differs);
+    
+    // Reseeding restarts the sequence
+    a.seed(42);
+    Xoshiro256 fresh(42);
+    EXPECT_EQ(a(), fresh());
+}
+
+TEST(RandomTest, BelowTest) {
+    Xoshiro256 rng(7);
+    EXPECT_EQ(rng.below(1), 0u);
+    
+    // Every value in range shows up about equally often
+    const int bound = 7;
+    const int draws = 70000;
+    std::vector<int> counts(bound, 0);
+    for (int i = 0; i < draws; ++i) {
+        uint32_t value = rng.below(bound);
+        ASSERT_LT(value, static_cast<uint32_t>(bound));
+        ++counts[value];
+    }
+    for (int count : counts) {
+        EXPECT_NEAR(count, draws / bound, draws / bound / 10);
+    }
+    
+    // Large bounds stay in range too
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_LT(rng.below(0xFFFFFFFFu), 0xFFFFFFFFu);
+    }
+}
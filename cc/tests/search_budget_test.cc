@@ -0,0 +1,180 @@
+#include "../mcts/mcts.h"
+#include "search_test_positions.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+class SearchBudgetTest : public ::testing::Test {
+protected:
+    using Mode = MCTSConfig::SearchMode;
+
+    void SetUp() override {
+        config.num_simulations = 1000;
+        config.use_heuristic = true;
+        config.use_move_ordering = true;
+        config.num_threads = 1;
+    }
+
+    MCTSConfig config;
+};
+
+TEST_F(SearchBudgetTest, SimulationCountTest) {
+    config.num_simulations = 500;
+
+    for (Mode mode : {Mode::Tree, Mode::Root, Mode::Leaf}) {
+        for (int threads : {1, 4}) {
+            config.search_mode = mode;
+            config.num_threads = threads;
+            MCTS search(config);
+            TicTacToe fork = ticTacToeForkPosition();
+
+            search.selectAction(&fork);
+            EXPECT_EQ(search.getSimulationCount(), 500);
+            EXPECT_EQ(search.getSearchStats().simulations, 500);
+        }
+    }
+}
+
+TEST_F(SearchBudgetTest, TimeLimitTest) {
+    config.num_simulations = 0;
+    config.time_limit_ms = 50;
+
+    for (int threads : {1, 4}) {
+        config.num_threads = threads;
+        MCTS search(config);
+        TicTacToe fork = ticTacToeForkPosition();
+
+        auto start = std::chrono::steady_clock::now();
+        EXPECT_EQ(search.selectAction(&fork), 8);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        EXPECT_GT(search.getSimulationCount(), 100);
+        EXPECT_GE(elapsed, std::chrono::milliseconds(50));
+        EXPECT_LT(elapsed, std::chrono::milliseconds(1000));
+    }
+}
+
+TEST_F(SearchBudgetTest, NodeBudgetTest) {
+    config.num_simulations = 0;
+    config.max_nodes = 200;
+
+    for (Mode mode : {Mode::Tree, Mode::Root}) {
+        for (int threads : {1, 4}) {
+            SCOPED_TRACE(testing::Message() << "mode " << static_cast<int>(mode) << ", threads " << threads);
+            config.search_mode = mode;
+            config.num_threads = threads;
+            BasicMCTS<ConnectFour> search(config);
+            ConnectFour position(1);
+
+            // Stops at the budget, overshooting by at most one expansion
+            // per thread
+            ASSERT_GE(search.selectAction(&position), 0);
+            size_t nodes = search.getSearchStats().nodes_allocated;
+            size_t overshoot = threads * ConnectFour::COLS;
+            EXPECT_GE(nodes + overshoot, config.max_nodes);
+            EXPECT_LE(nodes, config.max_nodes + overshoot);
+            EXPECT_GT(search.getSimulationCount(), 0);
+        }
+    }
+}
+
+TEST_F(SearchBudgetTest, StopTest) {
+    // Without any budget the search only ends when stopped
+    config.num_simulations = 0;
+    config.num_threads = 4;
+    MCTS search(config);
+    TicTacToe fork = ticTacToeForkPosition();
+
+    std::thread stopper([&search] {
+        while (search.getSimulationCount() < 2000) {
+            std::this_thread::yield();
+        }
+        search.stop();
+    });
+    int action = search.selectAction(&fork);
+    stopper.join();
+
+    EXPECT_EQ(action, 8);
+    EXPECT_GE(search.getSimulationCount(), 2000);
+}
+
+TEST_F(SearchBudgetTest, StopDropsQueuedWorkTest) {
+    // Eight fixed shares of a large budget queue up on one shared worker
+    config.search_mode = Mode::Root;
+    config.deterministic = true;
+    config.seed = 5;
+    config.num_threads = 8;
+    config.num_simulations = 1 << 24;
+    config.thread_pool = std::make_shared<ThreadPool>(1);
+    BasicMCTS<ConnectFour> search(config);
+    ConnectFour position(1);
+
+    std::thread stopper([&search] {
+        while (search.getSimulationCount() < 2000) {
+            std::this_thread::yield();
+        }
+        search.stop();
+    });
+    auto start = std::chrono::steady_clock::now();
+    int action = search.selectAction(&position);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    stopper.join();
+
+    EXPECT_GE(action, 0);
+    EXPECT_LT(search.getSimulationCount(), config.num_simulations / 8);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(1000));
+}
+
+TEST_F(SearchBudgetTest, SeedTest) {
+    // A single-threaded search is fully determined by its seed
+    config.seed = 1234;
+    config.num_simulations = 300;
+
+    std::vector<int> runs[2];
+    for (auto& run : runs) {
+        BasicMCTS<ConnectFour> search(config);
+        ConnectFour position(1);
+        for (int move = 0; move < 6 && !position.isGameOver(); ++move) {
+            int action = search.selectAction(&position);
+            run.push_back(action);
+            position.makeMove(action);
+        }
+    }
+    EXPECT_EQ(runs[0], runs[1]);
+}
+
+TEST_F(SearchBudgetTest, DeterministicTest) {
+    config.deterministic = true;
+    config.num_threads = 4;
+    config.num_simulations = 200;
+
+    // Everything but the timings and the split of the work between threads
+    auto record = [](std::vector<double>& run, int action, const SearchStats& stats) {
+        run.insert(run.end(), {double(action), double(stats.simulations), double(stats.playouts),
+                               double(stats.nodes_allocated), double(stats.max_depth), stats.avg_depth,
+                               stats.value, double(stats.solved), double(stats.threads.size())});
+    };
+
+    // Seed 0 takes a fixed seed rather than a random one
+    for (uint64_t seed : {99, 0}) {
+        for (Mode mode : {Mode::Tree, Mode::Root, Mode::Leaf}) {
+            SCOPED_TRACE(testing::Message() << "seed " << seed << ", mode " << static_cast<int>(mode));
+            config.seed = seed;
+            config.search_mode = mode;
+
+            // Few simulations make the chosen moves sensitive to any difference
+            std::vector<double> runs[2];
+            for (auto& run : runs) {
+                BasicMCTS<ConnectFour> search(config);
+                ConnectFour position(1);
+                for (int move = 0; move < 10 && !position.isGameOver(); ++move) {
+                    int action = search.selectAction(&position);
+                    record(run, action, search.getSearchStats());
+                    position.makeMove(action);
+                }
+            }
+            EXPECT_EQ(runs[0], runs[1]);
+        }
+    }
+}
@@ -0,0 +1,208 @@
+#include "../mcts/mcts.h"
+#include "search_test_positions.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+class SearchModesTest : public ::testing::Test {
+protected:
+    using Mode = MCTSConfig::SearchMode;
+
+    void SetUp() override {
+        config.num_simulations = 2000;
+        config.use_heuristic = true;
+        config.use_move_ordering = true;
+        config.num_threads = 4;
+        config.seed = 7;
+    }
+
+    MCTSConfig config;
+};
+
+TEST_F(SearchModesTest, FindsForcedWinTest) {
+    for (Mode mode : {Mode::Tree, Mode::Root, Mode::Leaf}) {
+        for (bool use_unmake : {false, true}) {
+            SCOPED_TRACE(testing::Message() << "mode " << static_cast<int>(mode) << ", unmake " << use_unmake);
+            config.search_mode = mode;
+            config.use_unmake = use_unmake;
+
+            // Through the virtual interface, leaving the position untouched
+            TicTacToe fork = ticTacToeForkPosition();
+            std::string before = fork.serialize();
+            MCTS search(config);
+            EXPECT_EQ(search.selectAction(&fork), 8);
+            EXPECT_EQ(search.getSimulationCount(), config.num_simulations);
+            EXPECT_EQ(fork.serialize(), before);
+
+            ConnectFour open_three = connectFourOpenThreePosition();
+            BasicMCTS<ConnectFour> c4_search(config);
+            EXPECT_EQ(c4_search.selectAction(&open_three), 3);
+            EXPECT_EQ(c4_search.getSimulationCount(), config.num_simulations);
+        }
+    }
+}
+
+TEST_F(SearchModesTest, ParallelWorkIsCombinedTest) {
+    for (Mode mode : {Mode::Tree, Mode::Root, Mode::Leaf}) {
+        SCOPED_TRACE(testing::Message() << "mode " << static_cast<int>(mode));
+        config.search_mode = mode;
+        BasicMCTS<ConnectFour> search(config);
+        ConnectFour position(1);
+        ASSERT_GE(search.selectAction(&position), 0);
+
+        // The threads' parts add up to the budget, merged at the root in
+        // root parallel search
+        const SearchStats& stats = search.getSearchStats();
+        EXPECT_EQ(stats.simulations, config.num_simulations);
+        EXPECT_EQ(stats.playouts, stats.simulations);
+        int thread_simulations = 0;
+        for (const auto& thread : stats.threads) {
+            thread_simulations += thread.simulations;
+        }
+        EXPECT_EQ(thread_simulations, stats.simulations);
+
+        if (mode == Mode::Leaf) {
+            // One tree descent feeds a rollout on every thread
+            EXPECT_LT(stats.nodes_allocated, static_cast<size_t>(config.num_simulations));
+        } else {
+            EXPECT_GT(stats.nodes_allocated, static_cast<size_t>(config.num_simulations));
+        }
+    }
+}
+
+TEST_F(SearchModesTest, ReuseTreeTest) {
+    // A re-rooted tree keeps the subtree of the played moves
+    config.num_threads = 1;
+    config.num_simulations = 1000;
+    size_t nodes[2];
+    for (bool reuse : {false, true}) {
+        config.reuse_tree = reuse;
+        BasicMCTS<ConnectFour> search(config);
+        ConnectFour position(1);
+        position.makeMove(search.selectAction(&position));
+        position.makeMove(search.selectAction(&position));
+        ASSERT_GE(search.selectAction(&position), 0);
+        EXPECT_EQ(search.getSimulationCount(), config.num_simulations);
+        nodes[reuse] = search.getSearchStats().nodes_allocated;
+    }
+    EXPECT_GT(nodes[1], nodes[0]);
+
+    // One search plays both sides, so the tree is re-rooted after every
+    // move; a reset board falls back to a fresh tree
+    config.reuse_tree = true;
+    config.num_simulations = 200;
+    for (bool unmake : {false, true}) {
+        for (int threads : {1, 4}) {
+            config.use_unmake = unmake;
+            config.num_threads = threads;
+            BasicMCTS<ConnectFour> search(config);
+            for (int round = 0; round < 2; ++round) {
+                ConnectFour game(1);
+                while (!game.isGameOver()) {
+                    int action = search.selectAction(&game);
+                    auto valid_actions = game.getPossibleActions();
+                    ASSERT_NE(std::find(valid_actions.begin(), valid_actions.end(), action),
+                              valid_actions.end());
+                    game.makeMove(action);
+                }
+            }
+        }
+    }
+
+    // A tree re-rooted past moves it did not choose still finds the win
+    config.num_threads = 1;
+    config.num_simulations = 2000;
+    BasicMCTS<ConnectFour> search(config);
+    ConnectFour game(1);
+    for (int col : {1, 6, 2, 6}) {
+        search.selectAction(&game);
+        game.makeMove(col);
+    }
+    EXPECT_EQ(search.selectAction(&game), 3);
+
+    // A tree filled to max_nodes is replaced rather than kept full
+    config.num_simulations = 0;
+    config.max_nodes = 500;
+    BasicMCTS<ConnectFour> bounded(config);
+    ConnectFour bounded_game(1);
+    for (int move = 0; move < 6; ++move) {
+        bounded_game.makeMove(bounded.selectAction(&bounded_game));
+        EXPECT_GT(bounded.getSimulationCount(), 0);
+    }
+
+    // Root parallel search starts fresh trees, so reuse changes nothing
+    config.search_mode = Mode::Root;
+    config.deterministic = true;
+    config.num_threads = 4;
+    config.num_simulations = 400;
+    config.max_nodes = 0;
+    std::vector<size_t> root_nodes[2];
+    for (bool reuse : {false, true}) {
+        config.reuse_tree = reuse;
+        BasicMCTS<ConnectFour> root_search(config);
+        ConnectFour root_game(1);
+        for (int move = 0; move < 4; ++move) {
+            root_game.makeMove(root_search.selectAction(&root_game));
+            root_nodes[reuse].push_back(root_search.getSearchStats().nodes_allocated);
+        }
+    }
+    EXPECT_EQ(root_nodes[0], root_nodes[1]);
+}
+
+TEST_F(SearchModesTest, TranspositionTest) {
+    config.use_transpositions = true;
+    config.transposition_table_size = 256;  // Small enough to force replacements
+
+    for (Mode mode : {Mode::Tree, Mode::Root, Mode::Leaf}) {
+        for (bool unmake : {false, true}) {
+            SCOPED_TRACE(testing::Message() << "mode " << static_cast<int>(mode) << ", unmake " << unmake);
+            config.search_mode = mode;
+            config.use_unmake = unmake;
+            BasicMCTS<ConnectFour> search(config);
+
+            ConnectFour position = connectFourOpenThreePosition();
+            EXPECT_EQ(search.selectAction(&position), 3);
+            EXPECT_EQ(search.getSimulationCount(), config.num_simulations);
+        }
+    }
+
+    // Shared nodes stay shared when the tree is re-rooted; a whole game
+    // against itself ends in a draw
+    config.search_mode = Mode::Tree;
+    config.reuse_tree = true;
+    config.num_threads = 1;
+    BasicMCTS<TicTacToe> search(config);
+    TicTacToe game(1);
+    while (!game.isGameOver()) {
+        game.makeMove(search.selectAction(&game));
+    }
+    EXPECT_EQ(game.getWinner(), 0);
+}
+
+TEST_F(SearchModesTest, RolloutsPerNodeTest) {
+    config.rollouts_per_node = 8;
+    config.num_simulations = 500;
+
+    for (Mode mode : {Mode::Tree, Mode::Leaf}) {
+        for (bool unmake : {false, true}) {
+            SCOPED_TRACE(testing::Message() << "mode " << static_cast<int>(mode) << ", unmake " << unmake);
+            config.search_mode = mode;
+            config.use_unmake = unmake;
+            config.num_threads = mode == Mode::Leaf ? 4 : 1;
+
+            // Batched for ConnectFour, one at a time for other games
+            ConnectFour open_three = connectFourOpenThreePosition();
+            BasicMCTS<ConnectFour> c4_search(config);
+            EXPECT_EQ(c4_search.selectAction(&open_three), 3);
+            EXPECT_EQ(c4_search.getSearchStats().playouts, 8LL * config.num_simulations);
+
+            TicTacToe fork = ticTacToeForkPosition();
+            std::string before = fork.serialize();
+            MCTS search(config);
+            EXPECT_EQ(search.selectAction(&fork), 8);
+            EXPECT_EQ(search.getSearchStats().playouts, 8LL * config.num_simulations);
+            EXPECT_EQ(fork.serialize(), before);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#include "../mcts/mcts.h"
+#include "search_test_positions.h"
+#include <gtest/gtest.h>
+
+TEST(SearchStatsTest, CountersAddUpTest) {
+    using Mode = MCTSConfig::SearchMode;
+    MCTSConfig config;
+    config.num_threads = 4;
+    config.num_simulations = 400;
+    config.rollouts_per_node = 2;
+
+    for (Mode mode : {Mode::Tree, Mode::Root, Mode::Leaf}) {
+        SCOPED_TRACE(testing::Message() << "mode " << static_cast<int>(mode));
+        config.search_mode = mode;
+        BasicMCTS<ConnectFour> search(config);
+        ConnectFour position(1);
+        ASSERT_GE(search.selectAction(&position), 0);
+
+        const SearchStats& stats = search.getSearchStats();
+        EXPECT_EQ(stats.simulations, search.getSimulationCount());
+        EXPECT_EQ(stats.playouts, 2LL * stats.simulations);
+        EXPECT_GT(stats.nodes_allocated, 1u);
+        EXPECT_GE(stats.max_depth, 1);
+        EXPECT_GE(stats.avg_depth, 1.0);
+        EXPECT_LE(stats.avg_depth, stats.max_depth);
+        EXPECT_GT(stats.total_ms, 0);
+
+        int thread_simulations = 0;
+        long long thread_playouts = 0;
+        for (const auto& thread : stats.threads) {
+            thread_simulations += thread.simulations;
+            thread_playouts += thread.playouts;
+        }
+        EXPECT_EQ(thread_simulations, stats.simulations);
+        EXPECT_EQ(thread_playouts, stats.playouts);
+#if GAME_AI_SEARCH_STATS
+        EXPECT_GT(stats.simulate_ms, 0);
+        EXPECT_GT(stats.select_ms + stats.expand_ms + stats.backpropagate_ms, 0);
+#endif
+    }
+
+    // Serial search reports the calling thread only
+    config.num_threads = 1;
+    BasicMCTS<TicTacToe> serial(config);
+    TicTacToe fork = ticTacToeForkPosition();
+    EXPECT_EQ(serial.selectAction(&fork), 8);
+    ASSERT_EQ(serial.getSearchStats().threads.size(), 1u);
+    EXPECT_EQ(serial.getSearchStats().threads[0].simulations, 400);
+    EXPECT_GT(serial.getSearchStats().value, 0.0);
+}
+
+TEST(SearchStatsTest, MovesWithoutSearchTest) {
+    MCTSConfig config;
+    config.num_simulations = 400;
+    config.use_perfect_play = true;
+    config.exact_solver_threshold = 10;
+    BasicMCTS<ConnectFour> search(config);
+
+    // A searched move first, so stale numbers would show below
+    ConnectFour position(1);
+    ASSERT_GE(search.selectAction(&position), 0);
+    ASSERT_EQ(search.getSearchStats().simulations, 400);
+
+    // Immediate win, forced block and an endgame for the exact solver
+    ConnectFour win(1);
+    for (int col : {0, 6, 0, 6, 0, 5}) win.makeMove(col);
+    ConnectFour block(1);
+    for (int col : {0, 6, 0, 6, 0}) block.makeMove(col);
+    ConnectFour endgame(1);
+    Xoshiro256 rng(3);
+    ActionList wins;
+    ActionList blocks;
+    do {
+        endgame = ConnectFour(1);
+        while (!endgame.isGameOver() && endgame.getMoveCount() < 34) {
+            auto actions = endgame.getPossibleActions();
+            endgame.makeMove(actions[rng.below(actions.size())]);
+        }
+        if (!endgame.isGameOver()) endgame.generateTacticalMoves(wins, blocks);
+    } while (endgame.isGameOver() || !wins.empty() || !blocks.empty());
+
+    for (ConnectFour* game : {&win, &block, &endgame}) {
+        ASSERT_GE(search.selectAction(game), 0);
+        const SearchStats& stats = search.getSearchStats();
+        EXPECT_EQ(stats.simulations, 0);
+        EXPECT_EQ(stats.playouts, 0);
+        EXPECT_EQ(stats.nodes_allocated, 0u);
+        EXPECT_TRUE(stats.threads.empty());
+        EXPECT_GT(stats.total_ms, 0);
+        EXPECT_EQ(stats.solved, game != &block);
+    }
+
+    // Tabulated Tic Tac Toe positions
+    BasicMCTS<TicTacToe> ttt_search(config);
+    TicTacToe fork = ticTacToeForkPosition();
+    EXPECT_EQ(ttt_search.selectAction(&fork), 8);
+    EXPECT_EQ(ttt_search.getSearchStats().simulations, 0);
+    EXPECT_GT(ttt_search.getSearchStats().total_ms, 0);
+    EXPECT_DOUBLE_EQ(ttt_search.getSearchStats().value, 1.0);
+}
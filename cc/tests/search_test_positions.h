@@ -0,0 +1,20 @@
+#pragma once
+#include "../games/connect_four.h"
+#include "../games/tic_tac_toe.h"
+
+// Positions with a single winning move that only search finds: neither
+// side can win at once and nothing must be blocked
+
+// X wins by force only with 8, which opens two lines at once
+inline TicTacToe ticTacToeForkPosition() {
+    TicTacToe game(1);
+    for (int cell : {0, 1, 2, 6}) game.makeMove(cell);
+    return game;
+}
+
+// Player 1 wins in three plies with column 3, leaving two open ends
+inline ConnectFour connectFourOpenThreePosition() {
+    ConnectFour game(1);
+    for (int col : {1, 6, 2, 6}) game.makeMove(col);
+    return game;
+}
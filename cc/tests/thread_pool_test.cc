@@ -0,0 +1,79 @@
+#include "../mcts/thread_pool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <set>
+#include <stdexcept>
+
+TEST(ThreadPoolTest, RunsEveryTaskTest) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4);
+    
+    std::atomic<int> sum{0};
+    std::vector<int> workers_seen(100, -1);
+    std::vector<ThreadPool::Task> tasks;
+    for (int i = 0; i < 100; ++i) {
+        tasks.push_back([&, i](int worker) {
+            sum += i;
+            workers_seen[i] = worker;
+        });
+    }
+    pool.run(tasks);
+    
+    EXPECT_EQ(sum.load(), 4950);
+    for (int worker : workers_seen) {
+        EXPECT_GE(worker, 0);
+        EXPECT_LT(worker, 4);
+    }
+}
+
+TEST(ThreadPoolTest, ReusedAcrossBatchesTest) {
+    ThreadPool pool(2);
+    std::atomic<int> count{0};
+    
+    for (int batch = 0; batch < 50; ++batch) {
+        std::vector<ThreadPool::Task> tasks(3, [&](int) { ++count; });
+        pool.run(tasks);
+    }
+    EXPECT_EQ(count.load(), 150);
+}
+
+TEST(ThreadPoolTest, TaskExceptionTest) {
+    ThreadPool pool(1);
+    std::atomic<int> count{0};
+    
+    // The first task throws; run() rethrows it and the rest are skipped
+    std::vector<ThreadPool::Task> tasks(10, [&](int) {
+        ++count;
+        throw std::runtime_error("task failed");
+    });
+    EXPECT_THROW(pool.run(tasks), std::runtime_error);
+    EXPECT_EQ(count.load(), 1);
+    
+    // The next batch runs normally
+    std::vector<ThreadPool::Task> more(5, [&](int) { ++count; });
+    EXPECT_NO_THROW(pool.run(more));
+    EXPECT_EQ(count.load(), 6);
+}
+
+TEST(ThreadPoolTest, CancelSkipsQueuedTasksTest) {
+    ThreadPool pool(1);
+    std::atomic<bool> cancel{false};
+    std::atomic<int> count{0};
+    
+    // The first task to run cancels the batch; the rest are skipped
+    std::vector<ThreadPool::Task> tasks(10, [&](int) {
+        ++count;
+        cancel = true;
+    });
+    pool.run(tasks, &cancel);
+    EXPECT_EQ(count.load(), 1);
+    
+    // Batches without the flag, or with it cleared, run every task
+    std::vector<ThreadPool::Task> more(5, [&](int) { ++count; });
+    pool.run(more);
+    EXPECT_EQ(count.load(), 6);
+    cancel = false;
+    std::vector<ThreadPool::Task> again(5, [&](int) { ++count; });
+    pool.run(again, &cancel);
+    EXPECT_EQ(count.load(), 11);
+}
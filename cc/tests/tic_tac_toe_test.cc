@@ -88,6 +88,18 @@ TEST_F(TicTacToeTest, PossibleActionsTest) {
     EXPECT_EQ(std::find(actions.begin(), actions.end(), 0), actions.end());
 }
 
+TEST_F(TicTacToeTest, GenerateActionsTest) {
+    game->makeMove(4);
+    game->makeMove(0);
+    
+    ActionList actions;
+    game->generateActions(actions);
+    auto expected = game->getPossibleActions();
+    ASSERT_EQ(actions.size(), static_cast<int>(expected.size()));
+    EXPECT_TRUE(std::equal(actions.begin(), actions.end(), expected.begin()));
+    EXPECT_FALSE(actions.contains(4));
+}
+
 TEST_F(TicTacToeTest, CloneTest) {
     game->makeMove(0);
     auto clone = game->clone();
@@ -99,6 +111,32 @@ TEST_F(TicTacToeTest, CloneTest) {
     EXPECT_NE(clone->getCurrentPlayer(), game->getCurrentPlayer());
 }
 
+TEST_F(TicTacToeTest, UnmakeMoveTest) {
+    game->makeMove(4);
+    std::string before = game->serialize();
+    
+    game->makeMove(0);
+    game->unmakeMove(0);
+    EXPECT_EQ(game->serialize(), before);
+    EXPECT_EQ(game->getCurrentPlayer(), 2);
+    
+    // Only the last mover's mark can be taken back
+    EXPECT_THROW(game->unmakeMove(0), std::invalid_argument);
+    EXPECT_THROW(game->unmakeMove(9), std::invalid_argument);
+}
+
+TEST_F(TicTacToeTest, HashTest) {
+    TicTacToe other(1);
+    for (int action : {0, 4, 8}) game->makeMove(action);
+    for (int action : {8, 4, 0}) other.makeMove(action);
+    EXPECT_EQ(game->getHash(), other.getHash());
+    
+    TicTacToe swapped(1);
+    for (int action : {4, 0, 8}) swapped.makeMove(action);
+    EXPECT_NE(game->getHash(), swapped.getHash());
+    EXPECT_NE(TicTacToe(1).getHash(), TicTacToe(2).getHash());
+}
+
 TEST_F(TicTacToeTest, SerializationTest) {
     game->makeMove(0);
     std::string state = game->serialize();
@@ -107,6 +145,29 @@ TEST_F(TicTacToeTest, SerializationTest) {
     EXPECT_EQ(new_game->getCurrentPlayer(), game->getCurrentPlayer());
 }
 
+TEST_F(TicTacToeTest, BinarySerializationTest) {
+    game->makeMove(4);
+    game->makeMove(0);
+    game->makeMove(8);
+    uint8_t buffer[Game::MAX_BINARY_SIZE];
+    size_t size = game->serializeBinary(buffer, sizeof(buffer));
+    ASSERT_GT(size, 0u);
+    EXPECT_LT(size * 3, game->serialize().size());
+    
+    TicTacToe restored(1);
+    EXPECT_TRUE(restored.deserializeBinary(buffer, size));
+    EXPECT_EQ(restored.serialize(), game->serialize());
+    EXPECT_EQ(restored.getHash(), game->getHash());
+    
+    // A cell held by both players is rejected
+    EXPECT_EQ(game->serializeBinary(buffer, size - 1), 0u);
+    buffer[2] = 0x01;
+    buffer[3] = 0x02;
+    buffer[4] = 0x00;
+    EXPECT_FALSE(restored.deserializeBinary(buffer, size));
+    EXPECT_EQ(restored.serialize(), game->serialize());
+}
+
 TEST_F(TicTacToeTest, WinningMoveTest) {
     // Test winning move detection
     game->makeMove(0); // X
@@ -117,6 +178,113 @@ TEST_F(TicTacToeTest, WinningMoveTest) {
     EXPECT_FALSE(game->isWinningMove(4)); // Not a winning move
 }
 
+TEST_F(TicTacToeTest, TacticalMovesTest) {
+    ActionList wins;
+    ActionList blocks;
+
+    // O threatens the middle column; X has no win yet
+    game->makeMove(0); // X
+    game->makeMove(4); // O
+    game->makeMove(8); // X
+    game->makeMove(1); // O
+    game->generateTacticalMoves(wins, blocks);
+    EXPECT_TRUE(wins.empty());
+    ASSERT_EQ(blocks.size(), 1);
+    EXPECT_EQ(blocks[0], 7);
+
+    // Blocking at 7 gives X the bottom row at 6; O threatens the middle row
+    game->makeMove(7); // X
+    game->makeMove(5); // O
+    game->generateTacticalMoves(wins, blocks);
+    ASSERT_EQ(wins.size(), 1);
+    EXPECT_EQ(wins[0], 6);
+    ASSERT_EQ(blocks.size(), 1);
+    EXPECT_EQ(blocks[0], 3);
+
+    // The default implementation agrees
+    ActionList expected_wins;
+    ActionList expected_blocks;
+    game->Game::generateTacticalMoves(expected_wins, expected_blocks);
+    ASSERT_EQ(expected_wins.size(), 1);
+    EXPECT_EQ(expected_wins[0], 6);
+    ASSERT_EQ(expected_blocks.size(), 1);
+    EXPECT_EQ(expected_blocks[0], 3);
+}
+
+namespace {
+
+// Plain minimax value for the side to move
+int minimax(TicTacToe& game) {
+    int best = -1;
+    for (int action : game.getPossibleActions()) {
+        int player = game.getCurrentPlayer();
+        game.makeMove(action);
+        int value = game.isGameOver() ? game.getReward(player) : -minimax(game);
+        game.unmakeMove(action);
+        best = std::max(best, value);
+    }
+    return best;
+}
+
+// Checks the table against minimax in every position reachable from game
+void checkPerfectPlay(TicTacToe& game, int& positions) {
+    if (game.isGameOver()) return;
+    ++positions;
+    
+    int action;
+    int value;
+    ASSERT_TRUE(game.lookupPerfectPlay(action, value));
+    EXPECT_EQ(value, minimax(game));
+    
+    // The table's move keeps the value
+    int player = game.getCurrentPlayer();
+    game.makeMove(action);
+    EXPECT_EQ(game.isGameOver() ? game.getReward(player) : -minimax(game), value);
+    game.unmakeMove(action);
+    
+    for (int next : game.getPossibleActions()) {
+        game.makeMove(next);
+        checkPerfectPlay(game, positions);
+        game.unmakeMove(next);
+    }
+}
+
+} // namespace
+
+TEST_F(TicTacToeTest, PerfectPlayTest) {
+    int action;
+    int value;
+    ASSERT_TRUE(game->lookupPerfectPlay(action, value));
+    EXPECT_EQ(value, 0);
+    
+    // X wins by force only with 8, which opens two lines at once
+    game->makeMove(0); // X
+    game->makeMove(1); // O
+    game->makeMove(2); // X
+    game->makeMove(6); // O
+    ASSERT_TRUE(game->lookupPerfectPlay(action, value));
+    EXPECT_EQ(value, 1);
+    EXPECT_EQ(action, 8);
+    
+    game->makeMove(8); // X threatens 4 and 5
+    ASSERT_TRUE(game->lookupPerfectPlay(action, value));
+    EXPECT_EQ(value, -1);
+    
+    game->makeMove(4); // O
+    game->makeMove(5); // X wins
+    EXPECT_FALSE(game->lookupPerfectPlay(action, value));
+}
+
+TEST_F(TicTacToeTest, PerfectPlayMatchesMinimaxTest) {
+    int positions = 0;
+    checkPerfectPlay(*game, positions);
+    EXPECT_GT(positions, 4000);
+    
+    TicTacToe second_starts(2);
+    second_starts.makeMove(4);
+    checkPerfectPlay(second_starts, positions);
+}
+
 TEST_F(TicTacToeTest, RewardTest) {
     // Test reward for winning
     game->makeMove(0); // X
@@ -0,0 +1,51 @@
+#include "../mcts/transposition_table.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+
+namespace {
+
+struct TestNode {
+    struct {
+        std::atomic<int> visits{0};
+    } stats;
+    uint64_t hash = 0;
+};
+
+} // namespace
+
+TEST(TranspositionTableTest, FindTest) {
+    TranspositionTable<TestNode> table(100);
+    EXPECT_EQ(table.capacity(), 128u);
+    
+    std::vector<TestNode> nodes(10);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        nodes[i].hash = i * 1000 + 7;
+        table.insert(&nodes[i]);
+    }
+    
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        EXPECT_EQ(table.find(nodes[i].hash), &nodes[i]);
+    }
+    EXPECT_EQ(table.find(12345), nullptr);
+}
+
+TEST(TranspositionTableTest, ReplacementTest) {
+    // A single bucket: the fifth node evicts the least visited one
+    TranspositionTable<TestNode> table(TranspositionTable<TestNode>::BUCKET_SIZE);
+    
+    std::vector<TestNode> nodes(5);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        nodes[i].hash = i + 1;
+        nodes[i].stats.visits = i == 2 ? 1 : 10;
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        table.insert(&nodes[i]);
+    }
+    table.insert(&nodes[4]);
+    
+    EXPECT_EQ(table.find(nodes[2].hash), nullptr);
+    for (size_t i : {0, 1, 3, 4}) {
+        EXPECT_EQ(table.find(nodes[i].hash), &nodes[i]);
+    }
+}
@@ -0,0 +1,89 @@
+#include "games/connect_four.h"
+#include "games/opening_book.h"
+#include "mcts/mcts.h"
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Searches every Connect Four position with at most max_depth stones and
+// writes the chosen moves to an opening book for GameManager to map.
+//
+// Usage: build_opening_book <output> [max_depth] [simulations]
+
+namespace {
+
+void collectPositions(ConnectFour& game, int max_depth, std::unordered_set<uint64_t>& seen,
+                      std::vector<ConnectFour>& positions) {
+    if (game.isGameOver() || !seen.insert(game.getHash()).second) return;
+    positions.push_back(game);
+    if (game.getMoveCount() >= max_depth) return;
+
+    ActionList actions;
+    game.generateActions(actions);
+    for (int action : actions) {
+        game.makeMove(action);
+        collectPositions(game, max_depth, seen, positions);
+        game.unmakeMove(action);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <output> [max_depth] [simulations]" << std::endl;
+        return 1;
+    }
+    std::string output = argv[1];
+    int max_depth = argc > 2 ? std::stoi(argv[2]) : 4;
+    int simulations = argc > 3 ? std::stoi(argv[3]) : 20000;
+
+    ConnectFour start(1);
+    std::unordered_set<uint64_t> seen;
+    std::vector<ConnectFour> positions;
+    collectPositions(start, max_depth, seen, positions);
+    std::cout << positions.size() << " positions up to depth " << max_depth << std::endl;
+
+    MCTSConfig config;
+    config.num_simulations = simulations;
+    // A fixed thread count keeps the book the same on every machine
+    config.num_threads = 4;
+    config.deterministic = true;
+    config.use_unmake = true;
+    config.use_solver = true;
+    config.use_transpositions = true;
+    config.seed = 1;
+    BasicMCTS<ConnectFour> search(config);
+
+    std::vector<OpeningBook::Entry> entries;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        ConnectFour& position = positions[i];
+        int move = search.selectAction(&position);
+        if (move < 0) continue;
+
+        // Forced blocks are played without a search or a value; the tactics
+        // check finds them again at play time
+        const SearchStats& stats = search.getSearchStats();
+        if (stats.simulations == 0 && !stats.solved) continue;
+
+        OpeningBook::Entry entry;
+        entry.key = OpeningBook::keyOf(position);
+        entry.value = static_cast<int16_t>(stats.value * 1000);
+        entry.move = static_cast<int8_t>(move);
+        entry.depth = static_cast<uint8_t>(position.getMoveCount());
+        entry.simulations = static_cast<uint32_t>(stats.simulations);
+        entries.push_back(entry);
+
+        if ((i + 1) % 100 == 0) {
+            std::cout << (i + 1) << "/" << positions.size() << std::endl;
+        }
+    }
+
+    if (!OpeningBook::write(output, entries)) {
+        std::cerr << "Failed to write " << output << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << entries.size() << " entries to " << output << std::endl;
+    return 0;
+}